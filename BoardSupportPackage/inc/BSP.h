@@ -20,6 +20,9 @@
 #include "Joystick.h"
 #include "RGBLeds.h"
 #include "LCDLib.h"
+#include "LCDStrip.h"
+#include "LCDSprite.h"
+#include "LCDShapes.h"
 
 
 
@@ -24,6 +24,37 @@ typedef enum
 /* Initializes back channel UART */
 extern void BackChannelInit();
 
+/*
+ * Writes a string to the back channel UART as it is (no JSON wrapping)
+ * Param 'string': A null-terminated C-string
+ */
+extern void BackChannelWrite(const char * string);
+
+/*
+ * Enables the receive interrupt of the back channel UART
+ * The handler for EUSCIA0_IRQn has to call BackChannelRxISR
+ */
+extern void BackChannelEnableRx();
+
+/*
+ * Moves a received byte into the receive ring
+ * Call from the EUSCIA0_IRQn handler
+ * Return: true if a byte was stored, false if there was none or the ring was full
+ */
+extern bool BackChannelRxISR();
+
+/*
+ * Takes the oldest byte out of the receive ring
+ * Return: the byte, or -1 if the ring is empty
+ */
+extern int32_t BackChannelGetChar();
+
+/*
+ * Reconfigures the baud rate generator after SMCLK has changed
+ * Param 'smclkFreq': New SMCLK frequency (12, 6 or 3 MHz)
+ */
+extern void BackChannelUpdateClock(uint32_t smclkFreq);
+
 /*
  * Prints string to the back channel UART
  * Param 'string': String to be displayed
@@ -9,6 +9,20 @@
 #ifndef CLOCKSYS_H_
 #define CLOCKSYS_H_
 
+#include <stdint.h>
+
+/*
+ * Clock levels for ClockSys_SetLevel, ordered from slowest to fastest
+ *  MCLK / HSMCLK / SMCLK, core voltage
+ */
+typedef enum
+{
+	ClockSys_Level12MHz = 0,	// 12 / 6 / 3 MHz, VCORE0
+	ClockSys_Level24MHz,		// 24 / 12 / 6 MHz, VCORE0
+	ClockSys_Level48MHz,		// 48 / 24 / 12 MHz, VCORE1
+	ClockSys_NumLevels
+} ClockSysLevel_t;
+
 /*
  * Initializes Core Clock to Maximum Frequency with highest accuracy
  * 	Initializes GPIO for HFXT in and out
@@ -21,7 +35,21 @@
  */
 extern void ClockSys_SetMaxFreq();
 
+/*
+ * Switches MCLK, HSMCLK, SMCLK and the core voltage to a clock level
+ *  Voltage and flash wait states are always raised before and lowered after the clocks
+ *  Peripherals clocked from SMCLK have to be reconfigured by the caller
+ *  Must be called after ClockSys_SetMaxFreq
+ */
+extern void ClockSys_SetLevel(ClockSysLevel_t level);
+
+/* Gets the clock level the system is running at */
+extern ClockSysLevel_t ClockSys_GetLevel();
+
 /* Gets the Main Clock System Frequency */
 extern uint32_t ClockSys_GetSysFreq();
 
+/* Gets the Subsystem Master Clock Frequency */
+extern uint32_t ClockSys_GetSMCLKFreq();
+
 #endif /* CLOCKSYS_H_ */
@@ -19,6 +19,31 @@
 #define MIN_SCREEN_Y     0
 #define SCREEN_SIZE      76800
 
+/* Fastest SPI clock used for the LCD */
+#define LCD_SPI_MAX_CLK  12000000
+
+/* DMA pixel path: channel 6 is triggered by EUSCI_B3 TX */
+#define LCD_DMA_CHANNEL        6
+#define LCD_DMA_MAX_TRANSFER   1024    /* bytes per DMA transfer, the uDMA limit */
+#define LCD_DMA_PATTERN_PIXELS 256     /* fill pattern for colors whose two bytes differ */
+#define LCD_DMA_MIN_PIXELS     32      /* smaller areas are written by the CPU, setup costs more than it saves */
+
+/* Bitmaps streamed by DMA are stored in the byte order the LCD receives them, MSB first */
+#define LCD_PIXEL(color) ((uint16_t)(((color) >> 8) | ((color) << 8)))
+
+/* DISPLAY_CONTROL_4: FMARKOE, one pulse every frame */
+#define LCD_FMARK_ENABLE       0x0008
+
+/* GATE_SCAN_CONTROL_0X61: REV as set by LCD_Init, plus VLE to use the scroll offset in 0x6A */
+#define LCD_SCROLL_ENABLE      0x0003
+
+/* Registers below this are cached, writes that do not change them are skipped */
+#define LCD_CACHED_REGISTERS   0xA0
+
+/* Glyph size of AsciiLib */
+#define LCD_FONT_WIDTH         8
+#define LCD_FONT_HEIGHT        16
+
 /* Register details */
 #define SPI_START   (0x70)     /* Start byte for SPI transfer        */
 #define SPI_RD      (0x01)     /* WR bit 1 within start              */
@@ -129,6 +154,111 @@ typedef struct Point {
  *******************************************************************************/
 void LCD_DrawRectangle(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t Color);
 
+/*******************************************************************************
+ * Function Name  : LCD_DrawBitmap
+ * Description    : Draw a bitmap into a rectangle
+ * Input          : xStart, xEnd, yStart, yEnd, pixels: (xEnd-xStart)*(yEnd-yStart) pixels, row by row
+ * Output         : None
+ * Return         : None
+ * Attention      : Pixels must be in LCD byte order (LCD_PIXEL), they are streamed by DMA
+ *******************************************************************************/
+void LCD_DrawBitmap(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels);
+
+/*******************************************************************************
+ * Function Name  : LCD_WritePixels
+ * Description    : Writes pixels at the GRAM cursor in one burst
+ * Input          : pixels: in LCD byte order (LCD_PIXEL), count
+ * Output         : None
+ * Return         : None
+ * Attention      : The index must be DATA_IN_GRAM, e.g. after LCD_SetWindow. Streamed by DMA unless count is small
+ *******************************************************************************/
+void LCD_WritePixels(const uint16_t *pixels, uint32_t count);
+
+/*******************************************************************************
+ * Function Name  : LCD_SetWindow
+ * Description    : Sets the GRAM window, moves the cursor to its start and selects GRAM
+ * Input          : xStart, xEnd, yStart, yEnd: window, the end coordinates are exclusive
+ * Output         : None
+ * Return         : None
+ * Attention      : Pixels written next fill the window left to right, top to bottom.
+ *                  Only the registers that differ from the cache are written, moving a window
+ *                  along one axis costs the two registers of that axis and the cursor
+ *******************************************************************************/
+void LCD_SetWindow(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd);
+
+/*******************************************************************************
+ * Function Name  : LCD_SetDMAHooks
+ * Description    : Lets the caller of a DMA transfer sleep until it is done
+ * Input          : wait: blocks until done has been called, e.g. waits on a semaphore
+ *                  done: called from the DMA interrupt at the end of every transfer, e.g. signals it
+ * Output         : None
+ * Return         : None
+ * Attention      : Without hooks the caller spins until the transfer is done
+ *******************************************************************************/
+void LCD_SetDMAHooks(void (*wait)(void), void (*done)(void));
+
+/*******************************************************************************
+ * Function Name  : LCD_InvalidateRegisterCache
+ * Description    : Forgets the cached register values, the next write of every register goes out
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Call after anything else has talked to the LCD, e.g. a reset outside of LCD_Init
+ *******************************************************************************/
+void LCD_InvalidateRegisterCache();
+
+/*******************************************************************************
+ * Function Name  : LCD_GetSkippedRegisterWrites
+ * Description    : Number of register and index writes the cache has skipped
+ * Input          : None
+ * Output         : None
+ * Return         : Skipped writes since LCD_Init, 6 SPI bytes for a register, 3 for the index
+ * Attention      : None
+ *******************************************************************************/
+uint32_t LCD_GetSkippedRegisterWrites();
+
+/*******************************************************************************
+ * Function Name  : LCD_SetFrameMarker
+ * Description    : Turns the FMARK output on or off, a pulse at the start of every frame
+ * Input          : enable
+ * Output         : None
+ * Return         : None
+ * Attention      : The pulse comes when the panel scans line 0. In landscape the panel scans along screen x
+ *******************************************************************************/
+void LCD_SetFrameMarker(bool enable);
+
+/*******************************************************************************
+ * Function Name  : LCD_SetScroll
+ * Description    : Sets the hardware scroll offset, the whole screen moves left by offset columns
+ * Input          : offset: columns, taken modulo MAX_SCREEN_X
+ * Output         : None
+ * Return         : None
+ * Attention      : The panel scrolls along its gate lines, which are screen x in landscape, so the scroll is horizontal
+ *                  and covers the whole screen. Afterwards screen column x is GRAM column LCD_ScreenToGRAMX(x)
+ *******************************************************************************/
+void LCD_SetScroll(uint16_t offset);
+
+/*******************************************************************************
+ * Function Name  : LCD_ScrollLeft
+ * Description    : Scrolls the screen left and clears the columns that come in on the right
+ * Input          : columns: 1 to MAX_SCREEN_X, Color: of the new columns
+ * Output         : None
+ * Return         : GRAM x of the first new column, draw the new content from there on
+ * Attention      : Costs one register write and a fill of the new columns, the rest of the screen is not redrawn.
+ *                  The new columns can wrap around GRAM column 0, LCD_ScreenToGRAMX maps every screen column
+ *******************************************************************************/
+int16_t LCD_ScrollLeft(uint16_t columns, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_ScreenToGRAMX
+ * Description    : GRAM column shown at a screen column under the current scroll offset
+ * Input          : x: screen column
+ * Output         : None
+ * Return         : GRAM column
+ * Attention      : None
+ *******************************************************************************/
+int16_t LCD_ScreenToGRAMX(int16_t x);
+
 /******************************************************************************
 * Function Name  : PutChar
 * Description    : Lcd screen displays a character
@@ -151,10 +281,24 @@ inline void PutChar( uint16_t Xpos, uint16_t Ypos, uint8_t ASCI, uint16_t charCo
 *                  - charColor: Character color
 * Output         : None
 * Return         : None
-* Attention      : None
+* Attention      : Only glyph pixels are written, one burst per run of them. Use LCD_TextBurst when the background is known
 *******************************************************************************/
 void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str,uint16_t Color);
 
+/******************************************************************************
+* Function Name  : LCD_TextBurst
+* Description    : Displays the string over a background color, each line in one window and one burst
+* Input          : - Xpos: Horizontal coordinate
+*                  - Ypos: Vertical coordinate
+*                  - str: Displayed string
+*                  - Color: Character color
+*                  - Background: Color of the rest of each character cell
+* Output         : None
+* Return         : None
+* Attention      : Wraps like LCD_Text
+*******************************************************************************/
+void LCD_TextBurst(uint16_t Xpos, uint16_t Ypos, const uint8_t *str, uint16_t Color, uint16_t Background);
+
 /*******************************************************************************
 * Function Name  : LCD_Write_Data_Only
 * Description    : Data writing to the LCD controller
@@ -288,6 +432,27 @@ inline void LCD_SetCursor(uint16_t Xpos, uint16_t Ypos );
 *******************************************************************************/
 void LCD_Init(bool usingTP);
 
+/*******************************************************************************
+ * Function Name  : LCD_UpdateSPIClock
+ * Description    : Recomputes the SPI clock divider after SMCLK has changed
+ * Input          : smclkFreq: new SMCLK frequency
+ * Output         : None
+ * Return         : None
+ * Attention      : SPI clock is SMCLK divided down to at most LCD_SPI_MAX_CLK. Must not be called while
+ *                  LCD_DMABusy, resetting the eUSCI under a running stream corrupts it
+ *******************************************************************************/
+void LCD_UpdateSPIClock(uint32_t smclkFreq);
+
+/*******************************************************************************
+ * Function Name  : LCD_DMABusy
+ * Description    : Tells whether a DMA stream to the LCD is running
+ * Input          : None
+ * Output         : None
+ * Return         : true from the start of a stream until its last transfer has been handed to the SPI
+ * Attention      : The SPI busy flag drops between DMA bytes, it does not cover a stream
+ *******************************************************************************/
+bool LCD_DMABusy();
+
 /*******************************************************************************
  * Function Name  : TP_ReadXY
  * Description    : Obtain X and Y touch coordinates
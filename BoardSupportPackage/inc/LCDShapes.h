@@ -0,0 +1,71 @@
+/*
+ * LCDShapes.h
+ *
+ * Lines, circles and rounded rectangles rasterized as spans
+ *  - Pixels in a row (or column) that belong to the same run are sent as one window and one burst,
+ *    instead of a cursor move and a register access per pixel as with LCD_SetPoint
+ *  - Shapes are clipped to the screen and may lie partly or completely off screen
+ *  - Every pixel is written once, the same pixels LCD_SetPoint would set with the textbook algorithms
+ */
+
+#ifndef LCDSHAPES_H_
+#define LCDSHAPES_H_
+
+#include <stdint.h>
+#include "LCDLib.h"
+
+/************************************ Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawLine
+ * Description    : Draws a one pixel wide line with Bresenham's algorithm
+ * Input          : x0, y0, x1, y1: both end points are drawn, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawCircle
+ * Description    : Draws the outline of a circle with the midpoint algorithm
+ * Input          : xCenter, yCenter, radius, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : The circle is 2*radius+1 pixels wide
+ *******************************************************************************/
+void LCD_DrawCircle(int16_t xCenter, int16_t yCenter, int16_t radius, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_FillCircle
+ * Description    : Draws a filled circle, one span per row
+ * Input          : xCenter, yCenter, radius, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : Covers exactly the outline of LCD_DrawCircle and its inside
+ *******************************************************************************/
+void LCD_FillCircle(int16_t xCenter, int16_t yCenter, int16_t radius, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawRoundRect
+ * Description    : Draws the outline of a rectangle with rounded corners
+ * Input          : xStart, xEnd, yStart, yEnd: same as LCD_DrawRectangle, radius: of the corners, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : radius is cut to what fits the rectangle, 0 gives square corners
+ *******************************************************************************/
+void LCD_DrawRoundRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, int16_t radius, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_FillRoundRect
+ * Description    : Draws a filled rectangle with rounded corners
+ * Input          : xStart, xEnd, yStart, yEnd: same as LCD_DrawRectangle, radius: of the corners, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : radius is cut to what fits the rectangle, 0 gives square corners
+ *******************************************************************************/
+void LCD_FillRoundRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, int16_t radius, uint16_t Color);
+
+/************************************ Public Functions  *******************************************/
+
+#endif /* LCDSHAPES_H_ */
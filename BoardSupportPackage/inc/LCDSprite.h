@@ -0,0 +1,71 @@
+/*
+ * LCDSprite.h
+ *
+ * Sprites stored in flash, raw, palette or run length encoded RGB565
+ *  - Rows are decoded on the fly into a line buffer and streamed into one LCD window, nothing is decoded ahead
+ *  - Sprites are clipped against the screen edges, parts off screen cost nothing but skipping them
+ *  - Keyed sprites leave the pixels of their color key untouched, each run of other pixels is written in one burst
+ *  - tools/sprite2c.py converts images into the C arrays below
+ */
+
+#ifndef LCDSPRITE_H_
+#define LCDSPRITE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "LCDLib.h"
+
+/************************************ Defines *******************************************/
+
+/* Widest sprite the line buffer holds */
+#define LCD_SPRITE_MAX_WIDTH   MAX_SCREEN_X
+
+/* RLE header word: literal flag, pixels in the run */
+#define LCD_RLE_LITERAL        0x8000
+#define LCD_RLE_COUNT_MASK     0x7FFF
+
+/************************************ Defines *******************************************/
+
+/********************************** Structures ******************************************/
+
+/*
+ * Pixel formats, all colors are RGB565 as used by LCD_DrawRectangle
+ *  - RAW: width * height colors
+ *  - PAL8: width * height bytes indexing palette
+ *  - RLE: runs that may cross rows, a header word then
+ *      - LCD_RLE_LITERAL | n: n colors follow
+ *      - n: one color follows, repeated n times
+ */
+typedef enum {
+    LCD_SPRITE_RAW = 0,
+    LCD_SPRITE_PAL8,
+    LCD_SPRITE_RLE
+} LCD_SpriteFormat;
+
+typedef struct LCD_Sprite {
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;
+    bool keyed;
+    uint16_t key;               // color left transparent when keyed
+    const uint16_t *palette;    // PAL8 only
+    const void *data;
+} LCD_Sprite;
+
+/********************************** Structures ******************************************/
+
+/************************************ Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawSprite
+ * Description    : Draws a sprite with its top left corner at (x, y), clipped to the screen
+ * Input          : sprite, x, y: may be off screen
+ * Output         : None
+ * Return         : None
+ * Attention      : Sprites wider than LCD_SPRITE_MAX_WIDTH are not drawn
+ *******************************************************************************/
+void LCD_DrawSprite(const LCD_Sprite *sprite, int16_t x, int16_t y);
+
+/************************************ Public Functions  *******************************************/
+
+#endif /* LCDSPRITE_H_ */
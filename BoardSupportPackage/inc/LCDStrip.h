@@ -0,0 +1,121 @@
+/*
+ * LCDStrip.h
+ *
+ * Flicker free drawing of overlapping items
+ *  - A full frame does not fit in SRAM, so a scene (rectangles, bitmaps, text) is rendered a strip of lines at a time
+ *    into one buffer and every strip is sent with one window and one DMA burst
+ *  - Items are drawn in the order they were added, later items cover earlier ones, the LCD never shows a partly drawn strip
+ *  - SRAM budget: the strip buffer is 2 * MAX_SCREEN_X * LCD_STRIP_LINES bytes, linked in with LCD_RenderScene.
+ *    The thread stacks take 46 KB of the 64 KB SRAM and the kernel and LCDLib buffers most of the rest,
+ *    the default of 4 lines (2.5 KB) leaves room for the application. More lines mean fewer windows
+ *    and DMA bursts per frame, define LCD_STRIP_LINES for the build only if the map file shows room for it
+ */
+
+#ifndef LCDSTRIP_H_
+#define LCDSTRIP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "LCDLib.h"
+
+/************************************ Defines *******************************************/
+
+/* Strip buffer, 4 full width lines (2.5 KB). Narrower regions get more lines per strip */
+#ifndef LCD_STRIP_LINES
+#define LCD_STRIP_LINES        4
+#endif
+#define LCD_STRIP_PIXELS       (MAX_SCREEN_X * LCD_STRIP_LINES)
+
+/* Items of one scene */
+#define LCD_SCENE_MAX_ITEMS    32
+
+/************************************ Defines *******************************************/
+
+/********************************** Structures ******************************************/
+
+typedef enum {
+    LCD_SCENE_RECT = 0,
+    LCD_SCENE_BITMAP,
+    LCD_SCENE_TEXT
+} LCD_SceneItemType;
+
+/*
+ * Item of a scene, end coordinates are exclusive
+ *  - Bitmaps and strings are not copied, they must stay unchanged while the scene is rendered
+ */
+typedef struct LCD_SceneItem {
+    uint8_t type;
+    uint16_t color;
+    int16_t xStart;
+    int16_t xEnd;
+    int16_t yStart;
+    int16_t yEnd;
+    union {
+        const uint16_t *pixels;
+        const char *text;
+    } data;
+} LCD_SceneItem;
+
+typedef struct LCD_Scene {
+    uint16_t background;
+    uint32_t numberOfItems;
+    LCD_SceneItem items[LCD_SCENE_MAX_ITEMS];
+} LCD_Scene;
+
+/********************************** Structures ******************************************/
+
+/************************************ Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneInit
+ * Description    : Empties a scene
+ * Input          : scene, background: color under all items
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_SceneInit(LCD_Scene *scene, uint16_t background);
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddRect
+ * Description    : Adds a filled rectangle on top of the scene
+ * Input          : scene, xStart, xEnd, yStart, yEnd, Color
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : None
+ *******************************************************************************/
+bool LCD_SceneAddRect(LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddBitmap
+ * Description    : Adds a bitmap on top of the scene
+ * Input          : scene, xStart, xEnd, yStart, yEnd, pixels: (xEnd-xStart)*(yEnd-yStart) pixels, row by row
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : Pixels must be in LCD byte order (LCD_PIXEL), same as LCD_DrawBitmap
+ *******************************************************************************/
+bool LCD_SceneAddBitmap(LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels);
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddText
+ * Description    : Adds a string on top of the scene, only the glyph pixels cover what is below
+ * Input          : scene, Xpos, Ypos: top left of the first character, str, Color
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : Does not wrap like LCD_Text, characters past the screen edge are cut
+ *******************************************************************************/
+bool LCD_SceneAddText(LCD_Scene *scene, int16_t Xpos, int16_t Ypos, const char *str, uint16_t Color);
+
+/*******************************************************************************
+ * Function Name  : LCD_RenderScene
+ * Description    : Renders part of a scene strip by strip and sends every strip in one burst
+ * Input          : scene, xStart, xEnd, yStart, yEnd: region to redraw, cut to the screen
+ * Output         : None
+ * Return         : None
+ * Attention      : Items outside of the region are not drawn, pass the whole screen to draw everything
+ *******************************************************************************/
+void LCD_RenderScene(const LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd);
+
+/************************************ Public Functions  *******************************************/
+
+#endif /* LCDSTRIP_H_ */
@@ -0,0 +1,21 @@
+/*
+ * RamFunc.h
+ * Execution of hot code paths from SRAM
+ *
+ *	Building with USE_RAMFUNC defined places every function marked RAMFUNC in the .TI.ramfunc section.
+ *	msp432p401r.cmd loads that section into flash and runs it from SRAM_CODE, and the boot routine
+ *	copies it through the BINIT table before main. SRAM is read with no wait states, flash needs 2 at 48 MHz.
+ *
+ *	Without USE_RAMFUNC the functions stay in flash, so both builds can be compared with G8RTOS_RunBenchmark.
+ */
+
+#ifndef RAMFUNC_H_
+#define RAMFUNC_H_
+
+#ifdef USE_RAMFUNC
+#define RAMFUNC __attribute__((ramfunc))
+#else
+#define RAMFUNC
+#endif
+
+#endif /* RAMFUNC_H_ */
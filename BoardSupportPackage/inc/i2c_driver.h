@@ -67,6 +67,7 @@ typedef enum {
 //
 //*****************************************************************************
 extern void initI2C(void);
+extern void updateI2CClock(uint32_t ui32ClkFreq);
 extern bool writeI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount);
 extern bool readI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount);
 extern bool readBurstI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint32_t ui32ByteCount);
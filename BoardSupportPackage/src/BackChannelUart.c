@@ -22,6 +22,9 @@
 
 #define SBUFF_SIZE 255
 
+/* Size of the receive ring, must be a power of 2 */
+#define RXBUFF_SIZE 64
+
 /******************************************* Defines *************************************/
 
 
@@ -41,9 +44,47 @@ static const eUSCI_UART_Config backChannelUart115200Config =
 		EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION 	// Oversampling
 };
 
+/* 115200 Baud from a 6 MHz SMCLK */
+static const eUSCI_UART_Config backChannelUart115200Config6MHz =
+{
+		EUSCI_A_UART_CLOCKSOURCE_SMCLK, 				// SMCLK Clock Source
+		3, 												// BRDIV
+		4, 												// UCxBRF
+		0x02, 											// UCxBRS
+		EUSCI_A_UART_NO_PARITY, 						// No Parity
+		EUSCI_A_UART_LSB_FIRST, 						// LSB First
+		EUSCI_A_UART_ONE_STOP_BIT, 						// One stop bit
+		EUSCI_A_UART_MODE, 								// UART mode
+		EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION 	// Oversampling
+};
+
+/* 115200 Baud from a 3 MHz SMCLK */
+static const eUSCI_UART_Config backChannelUart115200Config3MHz =
+{
+		EUSCI_A_UART_CLOCKSOURCE_SMCLK, 				// SMCLK Clock Source
+		1, 												// BRDIV
+		10, 											// UCxBRF
+		0x00, 											// UCxBRS
+		EUSCI_A_UART_NO_PARITY, 						// No Parity
+		EUSCI_A_UART_LSB_FIRST, 						// LSB First
+		EUSCI_A_UART_ONE_STOP_BIT, 						// One stop bit
+		EUSCI_A_UART_MODE, 								// UART mode
+		EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION 	// Oversampling
+};
+
 /* Buffer for holding created strings */
 static char backChannelStringBuff[SBUFF_SIZE];
 
+/*
+ * Receive ring
+ * Filled by BackChannelRxISR and emptied by BackChannelGetChar
+ * Each index is only written by one side, so no locking is needed
+ */
+static volatile uint8_t backChannelRxBuff[RXBUFF_SIZE];
+static volatile uint32_t backChannelRxHead;
+static volatile uint32_t backChannelRxTail;
+static volatile uint32_t backChannelRxDropped;
+
 /******************************************* Private Variables ***************************/
 
 
@@ -75,6 +116,107 @@ void BackChannelInit()
 	MAP_UART_enableModule(EUSCI_A0_BASE);
 }
 
+/*
+ * Writes a string to the back channel UART as it is (no JSON wrapping)
+ * Param 'string': A null-terminated C-string
+ */
+void BackChannelWrite(const char * string)
+{
+	BackChannelTransmitString((char *)string);
+}
+
+/*
+ * Enables the receive interrupt of the back channel UART
+ * The handler for EUSCIA0_IRQn has to call BackChannelRxISR
+ */
+void BackChannelEnableRx()
+{
+	backChannelRxHead = 0;
+	backChannelRxTail = 0;
+	backChannelRxDropped = 0;
+
+	MAP_UART_clearInterruptFlag(EUSCI_A0_BASE, EUSCI_A_UART_RECEIVE_INTERRUPT);
+	MAP_UART_enableInterrupt(EUSCI_A0_BASE, EUSCI_A_UART_RECEIVE_INTERRUPT);
+}
+
+/*
+ * Moves a received byte into the receive ring
+ * Call from the EUSCIA0_IRQn handler
+ * Return: true if a byte was stored, false if there was none or the ring was full
+ */
+bool BackChannelRxISR()
+{
+	if (!(UCA0IFG & UCRXIFG))
+	{
+		return false;
+	}
+
+	/* reading RXBUF clears the flag */
+	uint8_t byte = UCA0RXBUF;
+
+	if ((backChannelRxTail - backChannelRxHead) >= RXBUFF_SIZE)
+	{
+		backChannelRxDropped++;
+		return false;
+	}
+
+	backChannelRxBuff[backChannelRxTail & (RXBUFF_SIZE - 1)] = byte;
+	backChannelRxTail++;
+
+	return true;
+}
+
+/*
+ * Takes the oldest byte out of the receive ring
+ * Return: the byte, or -1 if the ring is empty
+ */
+int32_t BackChannelGetChar()
+{
+	if (backChannelRxHead == backChannelRxTail)
+	{
+		return -1;
+	}
+
+	int32_t byte = backChannelRxBuff[backChannelRxHead & (RXBUFF_SIZE - 1)];
+	backChannelRxHead++;
+
+	return byte;
+}
+
+/*
+ * Reconfigures the baud rate generator after SMCLK has changed
+ * Waits for the byte being shifted out to finish first
+ * Param 'smclkFreq': New SMCLK frequency (12, 6 or 3 MHz)
+ */
+void BackChannelUpdateClock(uint32_t smclkFreq)
+{
+	const eUSCI_UART_Config * config;
+
+	switch(smclkFreq)
+	{
+		case 6000000:
+		{
+			config = &backChannelUart115200Config6MHz;
+			break;
+		}
+		case 3000000:
+		{
+			config = &backChannelUart115200Config3MHz;
+			break;
+		}
+		case 12000000:
+		default:
+		{
+			config = &backChannelUart115200Config;
+		}
+	}
+
+	while(MAP_UART_queryStatusFlags(EUSCI_A0_BASE, EUSCI_A_UART_BUSY));
+
+	MAP_UART_initModule(EUSCI_A0_BASE, config);
+	MAP_UART_enableModule(EUSCI_A0_BASE);
+}
+
 /*
  * Prints string to the back channel UART
  * Param 'string': String to be displayed
@@ -12,6 +12,60 @@
 
 #include "ClockSys.h"
 
+/********************************** Private Variables *************************************/
+
+/*
+ * Settings of each clock level
+ *  - HSMCLK and SMCLK keep the same ratio to MCLK at every level (1/2 and 1/4)
+ *  - VCORE0 allows MCLK up to 24 MHz, flash needs 0 wait states up to 12 MHz and 1 up to 24 MHz
+ *  - VCORE1 with 2 wait states is needed for 48 MHz
+ */
+typedef struct ClockSysLevelConfig_t
+{
+	uint32_t coreVoltage;
+	uint32_t waitStates;
+	uint32_t mclkDivider;
+	uint32_t hsmclkDivider;
+	uint32_t smclkDivider;
+} ClockSysLevelConfig_t;
+
+static const ClockSysLevelConfig_t levelConfigs[ClockSys_NumLevels] =
+{
+	{ PCM_VCORE0, 0, CS_CLOCK_DIVIDER_4, CS_CLOCK_DIVIDER_8, CS_CLOCK_DIVIDER_16 },		// 12 MHz
+	{ PCM_VCORE0, 1, CS_CLOCK_DIVIDER_2, CS_CLOCK_DIVIDER_4, CS_CLOCK_DIVIDER_8 },		// 24 MHz
+	{ PCM_VCORE1, 2, CS_CLOCK_DIVIDER_1, CS_CLOCK_DIVIDER_2, CS_CLOCK_DIVIDER_4 }		// 48 MHz
+};
+
+/* Level the clocks are currently running at */
+static ClockSysLevel_t currentLevel = ClockSys_Level48MHz;
+
+/********************************** Private Variables *************************************/
+
+
+/********************************** Private Functions *************************************/
+
+/*
+ * Sets the flash wait states of both banks
+ */
+static inline void ClockSys_SetWaitStates(uint32_t waitStates)
+{
+	MAP_FlashCtl_setWaitState(FLASH_BANK0, waitStates);
+	MAP_FlashCtl_setWaitState(FLASH_BANK1, waitStates);
+}
+
+/*
+ * Sets MCLK, HSMCLK and SMCLK dividers of HFXT
+ */
+static inline void ClockSys_SetDividers(const ClockSysLevelConfig_t * config)
+{
+	MAP_CS_initClockSignal(CS_MCLK, CS_HFXTCLK_SELECT, config->mclkDivider);
+	MAP_CS_initClockSignal(CS_HSMCLK, CS_HFXTCLK_SELECT, config->hsmclkDivider);
+	MAP_CS_initClockSignal(CS_SMCLK, CS_HFXTCLK_SELECT, config->smclkDivider);
+}
+
+/********************************** Private Functions *************************************/
+
+
 /********************************** Public Functions **************************************/
 
 /*
@@ -54,6 +108,46 @@ void ClockSys_SetMaxFreq()
 
 	/* Initialize SMCLK to HFXT/4 */
 	MAP_CS_initClockSignal(CS_SMCLK, CS_HFXTCLK_SELECT, CS_CLOCK_DIVIDER_4);
+
+	currentLevel = ClockSys_Level48MHz;
+}
+
+/*
+ * Switches MCLK, HSMCLK, SMCLK and the core voltage to a clock level
+ *  - HFXT keeps running at 48 MHz, only the dividers change
+ *  - Going up: core voltage, then flash wait states, then clocks
+ *  - Going down: clocks, then flash wait states, then core voltage
+ *  - Peripherals clocked from SMCLK have to be reconfigured by the caller
+ */
+void ClockSys_SetLevel(ClockSysLevel_t level)
+{
+	if (level >= ClockSys_NumLevels || level == currentLevel)
+	{
+		return;
+	}
+
+	const ClockSysLevelConfig_t * config = &levelConfigs[level];
+
+	if (level > currentLevel)
+	{
+		while(!PCM_setCoreVoltageLevel(config->coreVoltage));
+		ClockSys_SetWaitStates(config->waitStates);
+		ClockSys_SetDividers(config);
+	}
+	else
+	{
+		ClockSys_SetDividers(config);
+		ClockSys_SetWaitStates(config->waitStates);
+		while(!PCM_setCoreVoltageLevel(config->coreVoltage));
+	}
+
+	currentLevel = level;
+}
+
+/* Gets the clock level the system is running at */
+ClockSysLevel_t ClockSys_GetLevel()
+{
+	return currentLevel;
 }
 
 /* Gets the Main Clock System Frequency */
@@ -62,4 +156,10 @@ uint32_t ClockSys_GetSysFreq()
 	return MAP_CS_getMCLK();
 }
 
+/* Gets the Subsystem Master Clock Frequency */
+uint32_t ClockSys_GetSMCLKFreq()
+{
+	return MAP_CS_getSMCLK();
+}
+
 /********************************** Public Functions **************************************/
@@ -5,13 +5,66 @@
  *      Author: Danny
  */
 
+#include <string.h>
 #include "LCDLib.h"
 #include "msp.h"
 #include "driverlib.h"
 #include "AsciiLib.h"
+#include "RamFunc.h"
+
+/************************************  Private Variables  *******************************************/
+
+/* uDMA control table, primary and alternate structures of all 8 channels, aligned to its size */
+#pragma DATA_ALIGN(lcdDMAControlTable, 256)
+static DMA_ControlTable lcdDMAControlTable[16];
+
+/* Fill pattern for colors whose two bytes differ, the color repeated in LCD byte order */
+static uint8_t lcdDMAPattern[2 * LCD_DMA_PATTERN_PIXELS];
+static uint16_t lcdDMAPatternColor = 0;
+
+/* Source byte of fills whose two bytes are equal, read by the DMA during the transfer */
+static uint8_t lcdDMAFillByte;
+
+/* Stream in progress: next source, bytes left after the transfer in flight, source increment, transfer size */
+static const uint8_t *lcdDMASource;
+static uint32_t lcdDMARemaining;
+static uint32_t lcdDMAIncrement;
+static uint32_t lcdDMAChunk;
+static bool lcdDMAAdvance;
+static volatile bool lcdDMABusy = false;
+
+/* Optional hooks that let the caller sleep during a stream */
+static void (*lcdDMAWait)(void) = 0;
+static void (*lcdDMADone)(void) = 0;
+
+/* Glyphs of the line of text being drawn, and one of its pixel rows in LCD byte order */
+static uint8_t lcdTextGlyphs[MAX_SCREEN_X / LCD_FONT_WIDTH][LCD_FONT_HEIGHT];
+static uint16_t lcdTextRow[MAX_SCREEN_X];
+
+/* Last value written to each cached register and to the index register, writes of the same value are skipped */
+static uint16_t lcdRegShadow[LCD_CACHED_REGISTERS];
+static uint32_t lcdRegValid[(LCD_CACHED_REGISTERS + 31) / 32];
+static uint16_t lcdIndexShadow;
+static bool lcdIndexValid = false;
+static uint32_t lcdSkippedWrites = 0;
+
+/* Hardware scroll offset, screen column x shows GRAM column (x + lcdScroll) % MAX_SCREEN_X */
+static uint16_t lcdScroll = 0;
+
+/************************************  Private Variables  *******************************************/
+
 
 /************************************  Private Functions  *******************************************/
 
+/*
+ * The GRAM address counter moves with every pixel written or read, the cached cursor is stale afterwards
+ */
+static inline void LCD_invalidateCursor()
+{
+    lcdRegValid[GRAM_HORIZONTAL_ADDRESS_SET / 32] &= ~(1 << (GRAM_HORIZONTAL_ADDRESS_SET % 32));
+    lcdRegValid[GRAM_VERTICAL_ADDRESS_SET / 32] &= ~(1 << (GRAM_VERTICAL_ADDRESS_SET % 32));
+}
+
 /*
  * Delay x ms
  */
@@ -48,7 +101,7 @@ static void LCD_initSPI()
     eUSCI_SPI_MasterConfig spiMasterConfig = {
       EUSCI_SPI_CLOCKSOURCE_SMCLK,
       12E6,
-      12E6,
+      LCD_SPI_MAX_CLK,
       EUSCI_SPI_MSB_FIRST,
       EUSCI_SPI_PHASE_DATA_CHANGED_ONFIRST_CAPTURED_ON_NEXT,
       EUSCI_SPI_CLOCKPOLARITY_INACTIVITY_HIGH,
@@ -79,6 +132,290 @@ static void LCD_reset()
     P10OUT |= BIT0;  // high
 }
 
+/*******************************************************************************
+ * Function Name  : LCD_initDMA
+ * Description    : Configures DMA channel 6 for EUSCI_B3 TX and its completion interrupt
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : The LCD owns the uDMA control table
+ *******************************************************************************/
+static void LCD_initDMA()
+{
+    uint32_t i = 0;
+
+    DMA_enableModule();
+    DMA_setControlBase(lcdDMAControlTable);
+    DMA_assignChannel(DMA_CH6_EUSCIB3TX0);
+    DMA_disableChannelAttribute(DMA_CH6_EUSCIB3TX0, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+
+    DMA_assignInterrupt(DMA_INT1, LCD_DMA_CHANNEL);
+    DMA_clearInterruptFlag(LCD_DMA_CHANNEL);
+    DMA_enableInterrupt(DMA_INT1);
+    NVIC_SetPriority(DMA_INT1_IRQn, 1);
+    NVIC_EnableIRQ(DMA_INT1_IRQn);
+
+    for (i = 0; i < sizeof(lcdDMAPattern); i++)
+    {
+        lcdDMAPattern[i] = 0;
+    }
+    lcdDMAPatternColor = 0;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_startDMATransfer
+ * Description    : Starts the next transfer of the stream in progress
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : UCTXIFG is cleared and raised again around enabling the channel, that is the first request.
+ *                  TXBUF has to be empty first, the wait is at most one byte
+ *******************************************************************************/
+static RAMFUNC void LCD_startDMATransfer()
+{
+    uint32_t size = (lcdDMARemaining < lcdDMAChunk) ? lcdDMARemaining : lcdDMAChunk;
+
+    DMA_setChannelControl(UDMA_PRI_SELECT | DMA_CH6_EUSCIB3TX0,
+                          UDMA_SIZE_8 | lcdDMAIncrement | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH6_EUSCIB3TX0, UDMA_MODE_BASIC, (void *)lcdDMASource,
+                           (void *)SPI_getTransmitBufferAddressForDMA(EUSCI_B3_BASE), size);
+
+    lcdDMARemaining -= size;
+    if (lcdDMAAdvance)
+    {
+        lcdDMASource += size;
+    }
+
+    while (!(UCB3IFG & UCTXIFG));
+    UCB3IFG &= ~UCTXIFG;
+    DMA_enableChannel(LCD_DMA_CHANNEL);
+    UCB3IFG |= UCTXIFG;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_streamDMA
+ * Description    : Sends bytes to the LCD by DMA, returns once the last one has been shifted out
+ * Input          : source: first byte
+ *                  count: bytes to send
+ *                  increment: UDMA_SRC_INC_8 or UDMA_SRC_INC_NONE
+ *                  advance: true if the source continues after each transfer, false if every transfer repeats it
+ *                  chunk: bytes per transfer, at most LCD_DMA_MAX_TRANSFER
+ * Output         : None
+ * Return         : None
+ * Attention      : CS must be low and the data start byte sent. Sleeps in the wait hook if one is set
+ *******************************************************************************/
+static void LCD_streamDMA(const uint8_t *source, uint32_t count, uint32_t increment, bool advance, uint32_t chunk)
+{
+    lcdDMASource = source;
+    lcdDMARemaining = count;
+    lcdDMAIncrement = increment;
+    lcdDMAAdvance = advance;
+    lcdDMAChunk = chunk;
+    lcdDMABusy = true;
+
+    LCD_startDMATransfer();
+
+    if (lcdDMAWait)
+    {
+        lcdDMAWait();
+    }
+    while (lcdDMABusy);
+
+    /* wait for the last byte, then drop the byte and overrun flag the stream left in RX */
+    while (UCB3STATW & UCBUSY);
+    (void)UCB3RXBUF;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_fill
+ * Description    : Writes count pixels of one color
+ * Input          : Color, count
+ * Output         : None
+ * Return         : None
+ * Attention      : CS must be low and the data start byte sent
+ *******************************************************************************/
+static RAMFUNC void LCD_fill(uint16_t Color, uint32_t count)
+{
+    uint32_t i = 0;
+    uint8_t msb = Color >> 8;
+    uint8_t lsb = Color & 0xFF;
+
+    if (count < LCD_DMA_MIN_PIXELS)
+    {
+        for (i = 0; i < count; i++)
+        {
+            LCD_Write_Data_Only(Color);
+        }
+        return;
+    }
+
+    /* both bytes equal: one fixed source byte */
+    if (msb == lsb)
+    {
+        lcdDMAFillByte = msb;
+        LCD_streamDMA(&lcdDMAFillByte, 2 * count, UDMA_SRC_INC_NONE, false, LCD_DMA_MAX_TRANSFER);
+        return;
+    }
+
+    /* otherwise repeat the pattern, rebuilt only when the color changes */
+    if (Color != lcdDMAPatternColor)
+    {
+        for (i = 0; i < sizeof(lcdDMAPattern); i += 2)
+        {
+            lcdDMAPattern[i] = msb;
+            lcdDMAPattern[i+1] = lsb;
+        }
+        lcdDMAPatternColor = Color;
+    }
+
+    LCD_streamDMA(lcdDMAPattern, 2 * count, UDMA_SRC_INC_8, false, sizeof(lcdDMAPattern));
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_textBurst
+ * Description    : Draws count characters of one line, glyph and background pixels, in one burst
+ * Input          : Xpos, Ypos, str, count, rows: glyph rows on screen, Color, Background
+ * Output         : None
+ * Return         : None
+ * Attention      : Glyphs must be in lcdTextGlyphs
+ *******************************************************************************/
+static void LCD_textBurst(uint16_t Xpos, uint16_t Ypos, uint32_t count, uint16_t rows, uint16_t Color, uint16_t Background)
+{
+    uint32_t width = count * LCD_FONT_WIDTH;
+    uint16_t foreground = LCD_PIXEL(Color);
+    uint16_t background = LCD_PIXEL(Background);
+    uint32_t i = 0;
+    uint16_t r = 0;
+    uint16_t j = 0;
+
+    LCD_SetWindow(Xpos, Xpos + width, Ypos, Ypos + rows);
+
+    SPI_CS_LOW;
+    LCD_Write_Data_Start();
+
+    for (r = 0; r < rows; r++)
+    {
+        uint16_t *pixel = lcdTextRow;
+        for (i = 0; i < count; i++)
+        {
+            uint8_t bits = lcdTextGlyphs[i][r];
+            for (j = 0; j < LCD_FONT_WIDTH; j++)
+            {
+                *pixel++ = (bits & (0x80 >> j)) ? foreground : background;
+            }
+        }
+
+        if (width < LCD_DMA_MIN_PIXELS)
+        {
+            for (i = 0; i < width; i++)
+            {
+                LCD_Write_Data_Only(LCD_PIXEL(lcdTextRow[i]));
+            }
+        }
+        else
+        {
+            LCD_streamDMA((const uint8_t *)lcdTextRow, 2 * width, UDMA_SRC_INC_8, true, LCD_DMA_MAX_TRANSFER);
+        }
+    }
+
+    SPI_CS_HIGH;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_textSpans
+ * Description    : Draws count characters of one line, only glyph pixels, one burst per run of set pixels
+ * Input          : Xpos, Ypos, count, rows: glyph rows on screen, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : Glyphs must be in lcdTextGlyphs
+ *******************************************************************************/
+static void LCD_textSpans(uint16_t Xpos, uint16_t Ypos, uint32_t count, uint16_t rows, uint16_t Color)
+{
+    uint32_t width = count * LCD_FONT_WIDTH;
+    uint32_t x = 0;
+    uint16_t r = 0;
+
+    /* the window lets the cursor go anywhere in the text, every run then only needs a cursor */
+    LCD_SetWindow(Xpos, Xpos + width, Ypos, Ypos + rows);
+
+    for (r = 0; r < rows; r++)
+    {
+        x = 0;
+        while (x < width)
+        {
+            uint32_t start = 0;
+
+            while (x < width && !(lcdTextGlyphs[x / LCD_FONT_WIDTH][r] & (0x80 >> (x % LCD_FONT_WIDTH))))
+            {
+                x++;
+            }
+            start = x;
+            while (x < width && (lcdTextGlyphs[x / LCD_FONT_WIDTH][r] & (0x80 >> (x % LCD_FONT_WIDTH))))
+            {
+                x++;
+            }
+
+            if (x > start)
+            {
+                LCD_SetCursor(Xpos + start, Ypos + r);
+                LCD_WriteIndex(DATA_IN_GRAM);
+
+                SPI_CS_LOW;
+                LCD_Write_Data_Start();
+                LCD_fill(Color, x - start);
+                SPI_CS_HIGH;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_drawText
+ * Description    : Draws a string line by line, wrapping at the right edge like LCD_Text
+ * Input          : Xpos, Ypos, str, Color, Background, opaque: draw background pixels as well
+ * Output         : None
+ * Return         : None
+ * Attention      : Lines past the bottom edge start over at the top
+ *******************************************************************************/
+static void LCD_drawText(uint16_t Xpos, uint16_t Ypos, const uint8_t *str, uint16_t Color, uint16_t Background, bool opaque)
+{
+    uint32_t length = strlen((const char *)str);
+
+    while (length)
+    {
+        uint32_t count = (Xpos < MAX_SCREEN_X) ? (MAX_SCREEN_X - Xpos) / LCD_FONT_WIDTH : 0;
+        uint16_t rows = (Ypos < MAX_SCREEN_Y) ? MAX_SCREEN_Y - Ypos : 0;
+        uint32_t i = 0;
+
+        count = (count < length) ? count : length;
+        rows = (rows < LCD_FONT_HEIGHT) ? rows : LCD_FONT_HEIGHT;
+
+        if (count && rows)
+        {
+            for (i = 0; i < count; i++)
+            {
+                GetASCIICode(lcdTextGlyphs[i], str[i]);
+            }
+
+            if (opaque)
+            {
+                LCD_textBurst(Xpos, Ypos, count, rows, Color, Background);
+            }
+            else
+            {
+                LCD_textSpans(Xpos, Ypos, count, rows, Color);
+            }
+
+            str += count;
+            length -= count;
+        }
+
+        Xpos = 0;
+        Ypos = (Ypos + 2 * LCD_FONT_HEIGHT <= MAX_SCREEN_Y) ? Ypos + LCD_FONT_HEIGHT : 0;
+    }
+}
+
 /************************************  Private Functions  *******************************************/
 
 
@@ -92,39 +429,252 @@ static void LCD_reset()
  * Return         : None
  * Attention      : Must draw from left to right, top to bottom!
  *******************************************************************************/
-void LCD_DrawRectangle(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t Color)
+RAMFUNC void LCD_DrawRectangle(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t Color)
 {
-    // Optimization complexity: O(64 + 2N) Bytes Written 
+    // Optimization complexity: O(64 + 2N) Bytes Written, the 2N by DMA
 
-    /* Check special cases for out of bounds */
-    if (xStart < 0 || xEnd > MAX_SCREEN_X || yStart < 0 || yEnd > MAX_SCREEN_Y)
+    /* Check special cases for out of bounds, and empty or inverted rectangles that would turn into a huge count */
+    if (xStart < 0 || xEnd > MAX_SCREEN_X || yStart < 0 || yEnd > MAX_SCREEN_Y || xEnd <= xStart || yEnd <= yStart)
     {
         return;
     }
 
     /* Set window area for high-speed RAM write */
+    LCD_SetWindow(xStart, xEnd, yStart, yEnd);
+
+    /* Send out data only to the entire area */
+    SPI_CS_LOW;
+    LCD_Write_Data_Start();
+    LCD_fill(Color, (xEnd-xStart)*(yEnd-yStart));
+    SPI_CS_HIGH;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawBitmap
+ * Description    : Draw a bitmap into a rectangle
+ * Input          : xStart, xEnd, yStart, yEnd, pixels: (xEnd-xStart)*(yEnd-yStart) pixels, row by row
+ * Output         : None
+ * Return         : None
+ * Attention      : Pixels must be in LCD byte order (LCD_PIXEL), they are streamed by DMA
+ *******************************************************************************/
+void LCD_DrawBitmap(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels)
+{
+    if (xStart < 0 || xEnd > MAX_SCREEN_X || yStart < 0 || yEnd > MAX_SCREEN_Y || xEnd <= xStart || yEnd <= yStart)
+    {
+        return;
+    }
+
+    LCD_SetWindow(xStart, xEnd, yStart, yEnd);
+    LCD_WritePixels(pixels, (xEnd-xStart)*(yEnd-yStart));
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_WritePixels
+ * Description    : Writes pixels at the GRAM cursor in one burst
+ * Input          : pixels: in LCD byte order (LCD_PIXEL), count
+ * Output         : None
+ * Return         : None
+ * Attention      : The index must be DATA_IN_GRAM, e.g. after LCD_SetWindow. Streamed by DMA unless count is small
+ *******************************************************************************/
+void LCD_WritePixels(const uint16_t *pixels, uint32_t count)
+{
+    uint32_t i = 0;
+
+    SPI_CS_LOW;
+    LCD_Write_Data_Start();
+
+    if (count < LCD_DMA_MIN_PIXELS)
+    {
+        for (i = 0; i < count; i++)
+        {
+            LCD_Write_Data_Only(LCD_PIXEL(pixels[i]));
+        }
+    }
+    else
+    {
+        LCD_streamDMA((const uint8_t *)pixels, 2 * count, UDMA_SRC_INC_8, true, LCD_DMA_MAX_TRANSFER);
+    }
+
+    SPI_CS_HIGH;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SetWindow
+ * Description    : Sets the GRAM window, moves the cursor to its start and selects GRAM
+ * Input          : xStart, xEnd, yStart, yEnd: window, the end coordinates are exclusive
+ * Output         : None
+ * Return         : None
+ * Attention      : Pixels written next fill the window left to right, top to bottom.
+ *                  Only the registers that differ from the cache are written, moving a window
+ *                  along one axis costs the two registers of that axis and the cursor
+ *******************************************************************************/
+RAMFUNC void LCD_SetWindow(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd)
+{
     LCD_WriteReg(HOR_ADDR_START_POS, yStart);     /* Horizontal GRAM Start Address */
     LCD_WriteReg(HOR_ADDR_END_POS, yEnd-1);  /* Horizontal GRAM End Address */
     LCD_WriteReg(VERT_ADDR_START_POS, xStart);    /* Vertical GRAM Start Address */
     LCD_WriteReg(VERT_ADDR_END_POS, xEnd-1); /* Vertical GRAM Start Address */
 
-    /* Set cursor */ 
+    /* Set cursor */
     LCD_SetCursor(xStart, yStart);
 
-    /* Set index to GRAM */ 
+    /* Set index to GRAM */
     LCD_WriteIndex(DATA_IN_GRAM);
+}
 
-    /* Send out data only to the entire area */
-    SPI_CS_LOW;
-    LCD_Write_Data_Start();
+/*******************************************************************************
+ * Function Name  : LCD_SetDMAHooks
+ * Description    : Lets the caller of a DMA transfer sleep until it is done
+ * Input          : wait: blocks until done has been called, e.g. waits on a semaphore
+ *                  done: called from the DMA interrupt at the end of every transfer, e.g. signals it
+ * Output         : None
+ * Return         : None
+ * Attention      : Without hooks the caller spins until the transfer is done
+ *******************************************************************************/
+void LCD_SetDMAHooks(void (*wait)(void), void (*done)(void))
+{
+    lcdDMAWait = wait;
+    lcdDMADone = done;
+}
 
-    int i = 0;
+/*******************************************************************************
+ * Function Name  : LCD_InvalidateRegisterCache
+ * Description    : Forgets the cached register values, the next write of every register goes out
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_InvalidateRegisterCache()
+{
+    uint32_t i = 0;
 
-    for (i = 0; i < ((xEnd-xStart)*(yEnd-yStart)); i++)
+    for (i = 0; i < sizeof(lcdRegValid) / sizeof(lcdRegValid[0]); i++)
     {
-        LCD_Write_Data_Only(Color);
+        lcdRegValid[i] = 0;
+    }
+    lcdIndexValid = false;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_GetSkippedRegisterWrites
+ * Description    : Number of register and index writes the cache has skipped
+ * Input          : None
+ * Output         : None
+ * Return         : Skipped writes since LCD_Init, 6 SPI bytes for a register, 3 for the index
+ * Attention      : None
+ *******************************************************************************/
+uint32_t LCD_GetSkippedRegisterWrites()
+{
+    return lcdSkippedWrites;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SetFrameMarker
+ * Description    : Turns the FMARK output on or off, a pulse at the start of every frame
+ * Input          : enable
+ * Output         : None
+ * Return         : None
+ * Attention      : The pulse comes when the panel scans line 0 (FRAME_MARKER_POSITION 0). In landscape the
+ *                  panel scans along screen x, so drawing started at the pulse stays behind the scan
+ *                  as long as the drawn columns are reached after the scan has passed them
+ *******************************************************************************/
+void LCD_SetFrameMarker(bool enable)
+{
+    LCD_WriteReg(FRAME_MARKER_POSITION, 0x0000);
+    LCD_WriteReg(DISPLAY_CONTROL_4, enable ? LCD_FMARK_ENABLE : 0x0000);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SetScroll
+ * Description    : Sets the hardware scroll offset, the whole screen moves left by offset columns
+ * Input          : offset: columns, taken modulo MAX_SCREEN_X
+ * Output         : None
+ * Return         : None
+ * Attention      : The panel scrolls along its gate lines, which are screen x in landscape, so the scroll is horizontal
+ *                  and covers the whole screen. Afterwards screen column x is GRAM column LCD_ScreenToGRAMX(x)
+ *******************************************************************************/
+void LCD_SetScroll(uint16_t offset)
+{
+    lcdScroll = offset % MAX_SCREEN_X;
+
+    LCD_WriteReg(GATE_SCAN_CONTROL_0X61, LCD_SCROLL_ENABLE);
+    LCD_WriteReg(GATE_SCAN_CONTROL_0X6A, lcdScroll);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_ScrollLeft
+ * Description    : Scrolls the screen left and clears the columns that come in on the right
+ * Input          : columns: 1 to MAX_SCREEN_X, Color: of the new columns
+ * Output         : None
+ * Return         : GRAM x of the first new column, draw the new content from there on
+ * Attention      : Costs one register write and a fill of the new columns, the rest of the screen is not redrawn.
+ *                  The new columns can wrap around GRAM column 0, LCD_ScreenToGRAMX maps every screen column
+ *******************************************************************************/
+int16_t LCD_ScrollLeft(uint16_t columns, uint16_t Color)
+{
+    int16_t first = lcdScroll;
+    int16_t beforeWrap = 0;
+
+    if (columns == 0 || columns > MAX_SCREEN_X)
+    {
+        return LCD_ScreenToGRAMX(MAX_SCREEN_X - 1);
+    }
+
+    /* the columns that scroll out on the left come back in on the right */
+    LCD_SetScroll(lcdScroll + columns);
+
+    beforeWrap = MAX_SCREEN_X - first;
+    if (columns <= beforeWrap)
+    {
+        LCD_DrawRectangle(first, first + columns, MIN_SCREEN_Y, MAX_SCREEN_Y, Color);
+    }
+    else
+    {
+        LCD_DrawRectangle(first, MAX_SCREEN_X, MIN_SCREEN_Y, MAX_SCREEN_Y, Color);
+        LCD_DrawRectangle(MIN_SCREEN_X, columns - beforeWrap, MIN_SCREEN_Y, MAX_SCREEN_Y, Color);
+    }
+
+    return first;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_ScreenToGRAMX
+ * Description    : GRAM column shown at a screen column under the current scroll offset
+ * Input          : x: screen column
+ * Output         : None
+ * Return         : GRAM column
+ * Attention      : None
+ *******************************************************************************/
+int16_t LCD_ScreenToGRAMX(int16_t x)
+{
+    return (x + lcdScroll) % MAX_SCREEN_X;
+}
+
+/*******************************************************************************
+ * Function Name  : DMA_INT1_IRQHandler
+ * Description    : End of an LCD DMA transfer, starts the next one or ends the stream
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Calls the done hook at the end of the stream
+ *******************************************************************************/
+RAMFUNC void DMA_INT1_IRQHandler(void)
+{
+    DMA_clearInterruptFlag(LCD_DMA_CHANNEL);
+
+    if (lcdDMARemaining)
+    {
+        LCD_startDMATransfer();
+        return;
+    }
+
+    lcdDMABusy = false;
+
+    if (lcdDMADone)
+    {
+        lcdDMADone();
     }
-    SPI_CS_HIGH;
 }
 
 /******************************************************************************
@@ -165,37 +715,28 @@ inline void PutChar( uint16_t Xpos, uint16_t Ypos, uint8_t ASCI, uint16_t charCo
  *                  - charColor: Character color
  * Output         : None
  * Return         : None
- * Attention      : None
+ * Attention      : Only glyph pixels are written, one burst per run of them. Use LCD_TextBurst when the background is known
  *******************************************************************************/
 void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color)
 {
-    uint8_t TempChar;
+    LCD_drawText(Xpos, Ypos, str, Color, 0, false);
+}
 
-    /* Set area back to span the entire LCD */
-    LCD_WriteReg(HOR_ADDR_START_POS, 0x0000);     /* Horizontal GRAM Start Address */
-    LCD_WriteReg(HOR_ADDR_END_POS, (MAX_SCREEN_Y - 1));  /* Horizontal GRAM End Address */
-    LCD_WriteReg(VERT_ADDR_START_POS, 0x0000);    /* Vertical GRAM Start Address */
-    LCD_WriteReg(VERT_ADDR_END_POS, (MAX_SCREEN_X - 1)); /* Vertical GRAM Start Address */
-    do
-    {
-        TempChar = *str++;
-        PutChar( Xpos, Ypos, TempChar, Color);
-        if( Xpos < MAX_SCREEN_X - 8)
-        {
-            Xpos += 8;
-        }
-        else if ( Ypos < MAX_SCREEN_X - 16)
-        {
-            Xpos = 0;
-            Ypos += 16;
-        }
-        else
-        {
-            Xpos = 0;
-            Ypos = 0;
-        }
-    }
-    while ( *str != 0 );
+/******************************************************************************
+ * Function Name  : LCD_TextBurst
+ * Description    : Displays the string over a background color, each line in one window and one burst
+ * Input          : - Xpos: Horizontal coordinate
+ *                  - Ypos: Vertical coordinate
+ *                  - str: Displayed string
+ *                  - Color: Character color
+ *                  - Background: Color of the rest of each character cell
+ * Output         : None
+ * Return         : None
+ * Attention      : Wraps like LCD_Text
+ *******************************************************************************/
+void LCD_TextBurst(uint16_t Xpos, uint16_t Ypos, const uint8_t *str, uint16_t Color, uint16_t Background)
+{
+    LCD_drawText(Xpos, Ypos, str, Color, Background, true);
 }
 
 
@@ -207,33 +748,16 @@ void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color)
  * Return         : None
  * Attention      : None
  *******************************************************************************/
-void LCD_Clear(uint16_t Color)
+RAMFUNC void LCD_Clear(uint16_t Color)
 {
-    /* Set area back to span the entire LCD */
-    LCD_WriteReg(HOR_ADDR_START_POS, 0x0000);     /* Horizontal GRAM Start Address */
-    LCD_WriteReg(HOR_ADDR_END_POS, (MAX_SCREEN_Y - 1));  /* Horizontal GRAM End Address */
-    LCD_WriteReg(VERT_ADDR_START_POS, 0x0000);    /* Vertical GRAM Start Address */
-    LCD_WriteReg(VERT_ADDR_END_POS, (MAX_SCREEN_X - 1)); /* Vertical GRAM Start Address */
-
-    /* Set cursor to (0,0) */ 
-    LCD_SetCursor(0, 0);
-
-    /* Set write index to GRAM */
-    LCD_WriteIndex(DATA_IN_GRAM);
+    /* Set area back to span the entire LCD, cursor to (0,0) */
+    LCD_SetWindow(0, MAX_SCREEN_X, 0, MAX_SCREEN_Y);
 
     /* Start data transmittion */
     SPI_CS_LOW;
     LCD_Write_Data_Start();
-
-    int i = 0;
-
-    for (i = 0; i < (MAX_SCREEN_X*MAX_SCREEN_Y); i++)
-    {
-        LCD_Write_Data_Only(Color);
-    }
+    LCD_fill(Color, MAX_SCREEN_X*MAX_SCREEN_Y);
     SPI_CS_HIGH;
-
-    // You'll need to call LCD_Write_Data_Start() and then send out only data to fill entire screen with color
 }
 
 /******************************************************************************
@@ -268,7 +792,7 @@ void LCD_SetPoint(uint16_t Xpos, uint16_t Ypos, uint16_t color)
  * Return         : None
  * Attention      : None
  *******************************************************************************/
-inline void LCD_Write_Data_Only(uint16_t data)
+RAMFUNC inline void LCD_Write_Data_Only(uint16_t data)
 {
     /* Send out MSB */ 
     SPISendRecvByte((data >> 8));
@@ -326,6 +850,14 @@ inline uint16_t LCD_ReadReg(uint16_t LCD_Reg)
  *******************************************************************************/
 inline void LCD_WriteIndex(uint16_t index)
 {
+    if (lcdIndexValid && lcdIndexShadow == index)
+    {
+        lcdSkippedWrites++;
+        return;
+    }
+    lcdIndexShadow = index;
+    lcdIndexValid = true;
+
     SPI_CS_LOW;
 
     /* SPI write data */
@@ -344,18 +876,18 @@ inline void LCD_WriteIndex(uint16_t index)
  * Return         : Recieved value 
  * Attention      : None
  *******************************************************************************/
-inline uint8_t SPISendRecvByte (uint8_t byte)
+RAMFUNC inline uint8_t SPISendRecvByte (uint8_t byte)
 {
     uint8_t ret = 0;
 
-    /* Send byte of data */
-    SPI_transmitData(EUSCI_B3_BASE, byte);
+    /* Send byte of data, through the register so no driverlib call leaves SRAM */
+    UCB3TXBUF = byte;
 
     /* Wait as long as busy */ 
     while (UCB3STATW & UCBUSY);
 
     /* Return received value*/
-    ret = SPI_receiveData(EUSCI_B3_BASE);
+    ret = UCB3RXBUF;
 
     return ret;
 }
@@ -370,6 +902,7 @@ inline uint8_t SPISendRecvByte (uint8_t byte)
  *******************************************************************************/
 inline void LCD_Write_Data_Start(void)
 {
+    LCD_invalidateCursor();
     SPISendRecvByte(SPI_START | SPI_WR | SPI_DATA);    /* Write : RS = 1, RW = 0 */
 }
 
@@ -384,6 +917,7 @@ inline void LCD_Write_Data_Start(void)
 inline uint16_t LCD_ReadData()
 {
     uint16_t value;
+    LCD_invalidateCursor();
     SPI_CS_LOW;
 
     SPISendRecvByte(SPI_START | SPI_RD | SPI_DATA);   /* Read: RS = 1, RW = 1   */
@@ -406,6 +940,24 @@ inline uint16_t LCD_ReadData()
  *******************************************************************************/
 inline void LCD_WriteReg(uint16_t LCD_Reg, uint16_t LCD_RegValue)
 {
+    /* GRAM data is never cached, it moves the cursor */
+    if (LCD_Reg == DATA_IN_GRAM)
+    {
+        LCD_invalidateCursor();
+    }
+    else if (LCD_Reg < LCD_CACHED_REGISTERS)
+    {
+        uint32_t bit = 1 << (LCD_Reg % 32);
+
+        if ((lcdRegValid[LCD_Reg / 32] & bit) && lcdRegShadow[LCD_Reg] == LCD_RegValue)
+        {
+            lcdSkippedWrites++;
+            return;
+        }
+        lcdRegShadow[LCD_Reg] = LCD_RegValue;
+        lcdRegValid[LCD_Reg / 32] |= bit;
+    }
+
     /* Write 16-bit Index */
     LCD_WriteIndex(LCD_Reg);
 
@@ -443,6 +995,9 @@ inline void LCD_SetCursor(uint16_t Xpos, uint16_t Ypos )
 void LCD_Init(bool usingTP)
 {
     LCD_initSPI();
+    LCD_initDMA();
+    LCD_InvalidateRegisterCache();
+    lcdScroll = 0;
 
     if (usingTP)
     {
@@ -525,9 +1080,40 @@ void LCD_Init(bool usingTP)
     LCD_Clear(LCD_BLACK);
 }
 
+/*******************************************************************************
+ * Function Name  : LCD_UpdateSPIClock
+ * Description    : Recomputes the SPI clock divider after SMCLK has changed
+ * Input          : smclkFreq: new SMCLK frequency
+ * Output         : None
+ * Return         : None
+ * Attention      : Waits for the byte in flight, CS is left as it is
+ *******************************************************************************/
+void LCD_UpdateSPIClock(uint32_t smclkFreq)
+{
+    uint32_t spiFreq = (smclkFreq < LCD_SPI_MAX_CLK) ? smclkFreq : LCD_SPI_MAX_CLK;
+
+    while (UCB3STATW & UCBUSY);
+
+    SPI_changeMasterClock(EUSCI_B3_BASE, smclkFreq, spiFreq);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMABusy
+ * Description    : Tells whether a DMA stream to the LCD is running
+ * Input          : None
+ * Output         : None
+ * Return         : true from the start of a stream until its last transfer has been handed to the SPI
+ * Attention      : The SPI busy flag drops between DMA bytes, it does not cover a stream
+ *******************************************************************************/
+bool LCD_DMABusy()
+{
+    return lcdDMABusy;
+}
+
 inline uint16_t LCD_newReadData()
 {
     uint16_t value;
+    LCD_invalidateCursor();
     SPI_CS_LOW;
 
     SPISendRecvByte(SPI_START | SPI_RD | SPI_DATA);
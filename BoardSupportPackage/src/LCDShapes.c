@@ -0,0 +1,348 @@
+/*
+ * LCDShapes.c
+ */
+
+#include <stdbool.h>
+#include "LCDShapes.h"
+
+/************************************  Private Variables  *******************************************/
+
+/*
+ * Centers of the four corner arcs, inclusive. A circle has all four on its center,
+ * a rounded rectangle is a circle pulled apart between them
+ */
+typedef struct LCD_Corners {
+    int32_t left;
+    int32_t right;
+    int32_t top;
+    int32_t bottom;
+} LCD_Corners;
+
+/* Called for every run of the arc where y stays the same: x from first to last */
+typedef void (*LCD_ArcRun)(const LCD_Corners *corners, int32_t first, int32_t last, int32_t y, uint16_t Color);
+
+/************************************  Private Variables  *******************************************/
+
+
+/************************************  Private Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_span
+ * Description    : Clips a rectangle to the screen and fills it with one window and one burst
+ * Input          : x0, x1, y0, y1: inclusive, empty if x1 < x0 or y1 < y0, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static void LCD_span(int32_t x0, int32_t x1, int32_t y0, int32_t y1, uint16_t Color)
+{
+    x0 = (x0 < MIN_SCREEN_X) ? MIN_SCREEN_X : x0;
+    x1 = (x1 >= MAX_SCREEN_X) ? MAX_SCREEN_X - 1 : x1;
+    y0 = (y0 < MIN_SCREEN_Y) ? MIN_SCREEN_Y : y0;
+    y1 = (y1 >= MAX_SCREEN_Y) ? MAX_SCREEN_Y - 1 : y1;
+
+    if (x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+
+    LCD_DrawRectangle(x0, x1 + 1, y0, y1 + 1, Color);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_outlineRun
+ * Description    : Draws one run of the arc in all eight octants
+ * Input          : corners, first, last, y: run in the octant above the diagonal, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : Runs starting at 0 join up across the straight edges between the corners
+ *******************************************************************************/
+static void LCD_outlineRun(const LCD_Corners *corners, int32_t first, int32_t last, int32_t y, uint16_t Color)
+{
+    /* the point on the diagonal belongs to the row run, the column run stops before it */
+    int32_t columnLast = (last == y) ? last - 1 : last;
+
+    /* rows above and below */
+    if (first == 0)
+    {
+        LCD_span(corners->left - last, corners->right + last, corners->top - y, corners->top - y, Color);
+        if (y != 0 || corners->bottom != corners->top)
+        {
+            LCD_span(corners->left - last, corners->right + last, corners->bottom + y, corners->bottom + y, Color);
+        }
+    }
+    else
+    {
+        LCD_span(corners->left - last, corners->left - first, corners->top - y, corners->top - y, Color);
+        LCD_span(corners->right + first, corners->right + last, corners->top - y, corners->top - y, Color);
+        LCD_span(corners->left - last, corners->left - first, corners->bottom + y, corners->bottom + y, Color);
+        LCD_span(corners->right + first, corners->right + last, corners->bottom + y, corners->bottom + y, Color);
+    }
+
+    /* columns left and right, the same run mirrored on the diagonal */
+    if (first == 0)
+    {
+        LCD_span(corners->left - y, corners->left - y, corners->top - columnLast, corners->bottom + columnLast, Color);
+        if (y != 0 || corners->right != corners->left)
+        {
+            LCD_span(corners->right + y, corners->right + y, corners->top - columnLast, corners->bottom + columnLast, Color);
+        }
+    }
+    else if (columnLast >= first)
+    {
+        LCD_span(corners->left - y, corners->left - y, corners->top - columnLast, corners->top - first, Color);
+        LCD_span(corners->left - y, corners->left - y, corners->bottom + first, corners->bottom + columnLast, Color);
+        LCD_span(corners->right + y, corners->right + y, corners->top - columnLast, corners->top - first, Color);
+        LCD_span(corners->right + y, corners->right + y, corners->bottom + first, corners->bottom + columnLast, Color);
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_fillRun
+ * Description    : Fills the rows above and below the corners that one run of the arc bounds
+ * Input          : corners, first, last, y: run in the octant above the diagonal, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : Row 0 (and everything between the top and bottom corners) is left to the caller
+ *******************************************************************************/
+static void LCD_fillRun(const LCD_Corners *corners, int32_t first, int32_t last, int32_t y, uint16_t Color)
+{
+    /* rows first..last reach out to y, all of them in one rectangle */
+    first = (first == 0) ? 1 : first;
+    if (first <= last)
+    {
+        LCD_span(corners->left - y, corners->right + y, corners->top - last, corners->top - first, Color);
+        LCD_span(corners->left - y, corners->right + y, corners->bottom + first, corners->bottom + last, Color);
+    }
+
+    /* row y reaches out to the end of the run, unless the run ended on the diagonal which was just drawn */
+    if (last != y)
+    {
+        LCD_span(corners->left - last, corners->right + last, corners->top - y, corners->top - y, Color);
+        LCD_span(corners->left - last, corners->right + last, corners->bottom + y, corners->bottom + y, Color);
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_arc
+ * Description    : Walks one octant of a circle with the midpoint algorithm, run by run
+ * Input          : corners, radius, run: called for every run, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static void LCD_arc(const LCD_Corners *corners, int32_t radius, LCD_ArcRun run, uint16_t Color)
+{
+    int32_t x = 0;
+    int32_t y = radius;
+    int32_t decision = 1 - radius;
+    int32_t first = 0;
+
+    while (x <= y)
+    {
+        int32_t nextY = y;
+
+        if (decision < 0)
+        {
+            decision += 2 * x + 3;
+        }
+        else
+        {
+            decision += 2 * (x - y) + 5;
+            nextY--;
+        }
+
+        /* the run ends when y steps or the octant does */
+        if (nextY != y || x + 1 > nextY)
+        {
+            run(corners, first, x, y, Color);
+            first = x + 1;
+        }
+
+        x++;
+        y = nextY;
+    }
+}
+
+/*
+ * Corners of a rounded rectangle, radius cut so the arcs fit
+ */
+static int32_t LCD_roundCorners(LCD_Corners *corners, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, int16_t radius)
+{
+    int32_t size = ((xEnd - xStart) < (yEnd - yStart)) ? xEnd - xStart : yEnd - yStart;
+    int32_t r = (radius < (size - 1) / 2) ? radius : (size - 1) / 2;
+
+    r = (r < 0) ? 0 : r;
+    corners->left = xStart + r;
+    corners->right = xEnd - 1 - r;
+    corners->top = yStart + r;
+    corners->bottom = yEnd - 1 - r;
+
+    return r;
+}
+
+/*
+ * True if the box around a shape misses the screen
+ */
+static bool LCD_offScreen(int32_t x0, int32_t x1, int32_t y0, int32_t y1)
+{
+    return x1 < MIN_SCREEN_X || x0 >= MAX_SCREEN_X || y1 < MIN_SCREEN_Y || y0 >= MAX_SCREEN_Y;
+}
+
+/************************************  Private Functions  *******************************************/
+
+
+/************************************  Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawLine
+ * Description    : Draws a one pixel wide line with Bresenham's algorithm
+ * Input          : x0, y0, x1, y1: both end points are drawn, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t Color)
+{
+    int32_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int32_t dy = (y1 > y0) ? y0 - y1 : y1 - y0;
+    int32_t sx = (x0 < x1) ? 1 : -1;
+    int32_t sy = (y0 < y1) ? 1 : -1;
+    int32_t error = dx + dy;
+    bool steep = (-dy > dx);
+    int32_t x = x0;
+    int32_t y = y0;
+    int32_t runX = x0;
+    int32_t runY = y0;
+
+    if (LCD_offScreen((x0 < x1) ? x0 : x1, (x0 < x1) ? x1 : x0, (y0 < y1) ? y0 : y1, (y0 < y1) ? y1 : y0))
+    {
+        return;
+    }
+
+    while (1)
+    {
+        int32_t nextX = x;
+        int32_t nextY = y;
+        int32_t e2 = 2 * error;
+
+        if (x == x1 && y == y1)
+        {
+            break;
+        }
+
+        if (e2 >= dy)
+        {
+            error += dy;
+            nextX += sx;
+        }
+        if (e2 <= dx)
+        {
+            error += dx;
+            nextY += sy;
+        }
+
+        /* a run lasts while the minor axis stays, it goes out as one span */
+        if (steep ? (nextX != x) : (nextY != y))
+        {
+            LCD_span((runX < x) ? runX : x, (runX < x) ? x : runX, (runY < y) ? runY : y, (runY < y) ? y : runY, Color);
+            runX = nextX;
+            runY = nextY;
+        }
+
+        x = nextX;
+        y = nextY;
+    }
+
+    LCD_span((runX < x) ? runX : x, (runX < x) ? x : runX, (runY < y) ? runY : y, (runY < y) ? y : runY, Color);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawCircle
+ * Description    : Draws the outline of a circle with the midpoint algorithm
+ * Input          : xCenter, yCenter, radius, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : The circle is 2*radius+1 pixels wide
+ *******************************************************************************/
+void LCD_DrawCircle(int16_t xCenter, int16_t yCenter, int16_t radius, uint16_t Color)
+{
+    LCD_Corners corners = { xCenter, xCenter, yCenter, yCenter };
+
+    if (radius < 0 || LCD_offScreen(xCenter - radius, xCenter + radius, yCenter - radius, yCenter + radius))
+    {
+        return;
+    }
+
+    LCD_arc(&corners, radius, LCD_outlineRun, Color);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_FillCircle
+ * Description    : Draws a filled circle, one span per row
+ * Input          : xCenter, yCenter, radius, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : Covers exactly the outline of LCD_DrawCircle and its inside
+ *******************************************************************************/
+void LCD_FillCircle(int16_t xCenter, int16_t yCenter, int16_t radius, uint16_t Color)
+{
+    LCD_Corners corners = { xCenter, xCenter, yCenter, yCenter };
+
+    if (radius < 0 || LCD_offScreen(xCenter - radius, xCenter + radius, yCenter - radius, yCenter + radius))
+    {
+        return;
+    }
+
+    LCD_span(xCenter - radius, xCenter + radius, yCenter, yCenter, Color);
+    LCD_arc(&corners, radius, LCD_fillRun, Color);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawRoundRect
+ * Description    : Draws the outline of a rectangle with rounded corners
+ * Input          : xStart, xEnd, yStart, yEnd: same as LCD_DrawRectangle, radius: of the corners, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : radius is cut to what fits the rectangle, 0 gives square corners
+ *******************************************************************************/
+void LCD_DrawRoundRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, int16_t radius, uint16_t Color)
+{
+    LCD_Corners corners;
+    int32_t r = 0;
+
+    if (xStart >= xEnd || yStart >= yEnd || LCD_offScreen(xStart, xEnd - 1, yStart, yEnd - 1))
+    {
+        return;
+    }
+
+    r = LCD_roundCorners(&corners, xStart, xEnd, yStart, yEnd, radius);
+    LCD_arc(&corners, r, LCD_outlineRun, Color);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_FillRoundRect
+ * Description    : Draws a filled rectangle with rounded corners
+ * Input          : xStart, xEnd, yStart, yEnd: same as LCD_DrawRectangle, radius: of the corners, Color
+ * Output         : None
+ * Return         : None
+ * Attention      : radius is cut to what fits the rectangle, 0 gives square corners
+ *******************************************************************************/
+void LCD_FillRoundRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, int16_t radius, uint16_t Color)
+{
+    LCD_Corners corners;
+    int32_t r = 0;
+
+    if (xStart >= xEnd || yStart >= yEnd || LCD_offScreen(xStart, xEnd - 1, yStart, yEnd - 1))
+    {
+        return;
+    }
+
+    r = LCD_roundCorners(&corners, xStart, xEnd, yStart, yEnd, radius);
+
+    /* everything between the corner centers, full width */
+    LCD_span(xStart, xEnd - 1, corners.top, corners.bottom, Color);
+    LCD_arc(&corners, r, LCD_fillRun, Color);
+}
+
+/************************************  Public Functions  *******************************************/
@@ -0,0 +1,207 @@
+/*
+ * LCDSprite.c
+ */
+
+#include "LCDSprite.h"
+
+/************************************  Private Variables  *******************************************/
+
+/*
+ * Decoding state of one sprite, RLE runs carry over from row to row
+ */
+typedef struct LCD_SpriteDecoder {
+    const LCD_Sprite *sprite;
+    uint16_t row;
+    const uint16_t *rle;
+    uint16_t run;
+    bool literal;
+    uint16_t color;
+} LCD_SpriteDecoder;
+
+/* Decoded row in LCD byte order */
+static uint16_t spriteLine[LCD_SPRITE_MAX_WIDTH];
+
+/************************************  Private Variables  *******************************************/
+
+
+/************************************  Private Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_nextRun
+ * Description    : Reads the header of the next RLE run
+ * Input          : decoder
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static inline void LCD_nextRun(LCD_SpriteDecoder *decoder)
+{
+    uint16_t header = *decoder->rle++;
+
+    decoder->run = header & LCD_RLE_COUNT_MASK;
+    decoder->literal = (header & LCD_RLE_LITERAL) != 0;
+    if (!decoder->literal)
+    {
+        decoder->color = LCD_PIXEL(decoder->rle[0]);
+        decoder->rle++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_decodeRow
+ * Description    : Decodes the next row into line, or skips it
+ * Input          : decoder, line: width pixels, 0 to skip the row
+ * Output         : line in LCD byte order
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static void LCD_decodeRow(LCD_SpriteDecoder *decoder, uint16_t *line)
+{
+    const LCD_Sprite *sprite = decoder->sprite;
+    uint32_t width = sprite->width;
+    uint32_t offset = decoder->row * width;
+    uint32_t i = 0;
+
+    decoder->row++;
+
+    switch (sprite->format)
+    {
+    case LCD_SPRITE_RAW:
+    {
+        const uint16_t *pixels = (const uint16_t *)sprite->data + offset;
+        for (i = 0; line && i < width; i++)
+        {
+            line[i] = LCD_PIXEL(pixels[i]);
+        }
+        break;
+    }
+
+    case LCD_SPRITE_PAL8:
+    {
+        const uint8_t *indices = (const uint8_t *)sprite->data + offset;
+        for (i = 0; line && i < width; i++)
+        {
+            line[i] = LCD_PIXEL(sprite->palette[indices[i]]);
+        }
+        break;
+    }
+
+    case LCD_SPRITE_RLE:
+        while (i < width)
+        {
+            uint32_t count = 0;
+            uint32_t j = 0;
+
+            if (decoder->run == 0)
+            {
+                LCD_nextRun(decoder);
+            }
+
+            count = (decoder->run < width - i) ? decoder->run : width - i;
+            decoder->run -= count;
+
+            if (decoder->literal)
+            {
+                for (j = 0; line && j < count; j++)
+                {
+                    line[i + j] = LCD_PIXEL(decoder->rle[j]);
+                }
+                decoder->rle += count;
+            }
+            else
+            {
+                for (j = 0; line && j < count; j++)
+                {
+                    line[i + j] = decoder->color;
+                }
+            }
+
+            i += count;
+        }
+        break;
+    }
+}
+
+/************************************  Private Functions  *******************************************/
+
+
+/************************************  Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_DrawSprite
+ * Description    : Draws a sprite with its top left corner at (x, y), clipped to the screen
+ * Input          : sprite, x, y: may be off screen
+ * Output         : None
+ * Return         : None
+ * Attention      : Sprites wider than LCD_SPRITE_MAX_WIDTH are not drawn
+ *******************************************************************************/
+void LCD_DrawSprite(const LCD_Sprite *sprite, int16_t x, int16_t y)
+{
+    LCD_SpriteDecoder decoder = { sprite, 0, (const uint16_t *)sprite->data, 0, false, 0 };
+    int16_t xStart = (x > MIN_SCREEN_X) ? x : MIN_SCREEN_X;
+    int16_t xEnd = (x + sprite->width < MAX_SCREEN_X) ? x + sprite->width : MAX_SCREEN_X;
+    int16_t yStart = (y > MIN_SCREEN_Y) ? y : MIN_SCREEN_Y;
+    int16_t yEnd = (y + sprite->height < MAX_SCREEN_Y) ? y + sprite->height : MAX_SCREEN_Y;
+    uint16_t key = LCD_PIXEL(sprite->key);
+    int16_t row = 0;
+
+    if (sprite->width > LCD_SPRITE_MAX_WIDTH || xStart >= xEnd || yStart >= yEnd)
+    {
+        return;
+    }
+
+    /* rows above the screen, RAW and PAL8 could jump but RLE has to run through them */
+    if (sprite->format == LCD_SPRITE_RLE)
+    {
+        for (row = y; row < yStart; row++)
+        {
+            LCD_decodeRow(&decoder, 0);
+        }
+    }
+    else
+    {
+        decoder.row = yStart - y;
+    }
+
+    LCD_SetWindow(xStart, xEnd, yStart, yEnd);
+
+    for (row = yStart; row < yEnd; row++)
+    {
+        const uint16_t *visible = &spriteLine[xStart - x];
+
+        LCD_decodeRow(&decoder, spriteLine);
+
+        if (!sprite->keyed)
+        {
+            /* the window wraps the cursor to the next row */
+            LCD_WritePixels(visible, xEnd - xStart);
+            continue;
+        }
+
+        /* keyed: one burst per run of opaque pixels, the window lets the cursor jump to any of them */
+        int16_t i = 0;
+        while (i < xEnd - xStart)
+        {
+            int16_t start = 0;
+
+            while (i < xEnd - xStart && visible[i] == key)
+            {
+                i++;
+            }
+            start = i;
+            while (i < xEnd - xStart && visible[i] != key)
+            {
+                i++;
+            }
+
+            if (i > start)
+            {
+                LCD_SetCursor(xStart + start, row);
+                LCD_WriteIndex(DATA_IN_GRAM);
+                LCD_WritePixels(&visible[start], i - start);
+            }
+        }
+    }
+}
+
+/************************************  Public Functions  *******************************************/
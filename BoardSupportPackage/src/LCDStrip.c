@@ -0,0 +1,249 @@
+/*
+ * LCDStrip.c
+ */
+
+#include <string.h>
+#include "LCDStrip.h"
+#include "AsciiLib.h"
+
+/************************************  Private Variables  *******************************************/
+
+/* Strip being rendered, in LCD byte order, row by row */
+static uint16_t stripBuffer[LCD_STRIP_PIXELS];
+
+/************************************  Private Variables  *******************************************/
+
+
+/************************************  Private Functions  *******************************************/
+
+/*
+ * Adds an item, returns the slot or 0 if the scene is full
+ */
+static LCD_SceneItem *LCD_SceneAdd(LCD_Scene *scene, uint8_t type, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd)
+{
+    LCD_SceneItem *item = 0;
+
+    if (scene->numberOfItems == LCD_SCENE_MAX_ITEMS)
+    {
+        return 0;
+    }
+
+    item = &scene->items[scene->numberOfItems++];
+    item->type = type;
+    item->xStart = xStart;
+    item->xEnd = xEnd;
+    item->yStart = yStart;
+    item->yEnd = yEnd;
+
+    return item;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_renderItem
+ * Description    : Draws the part of an item inside a strip into the strip buffer
+ * Input          : item, xStart, xEnd, yStart, yEnd: strip, the buffer holds (xEnd-xStart) pixels per row
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static void LCD_renderItem(const LCD_SceneItem *item, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd)
+{
+    int16_t width = xEnd - xStart;
+    int16_t x0 = (item->xStart > xStart) ? item->xStart : xStart;
+    int16_t x1 = (item->xEnd < xEnd) ? item->xEnd : xEnd;
+    int16_t y0 = (item->yStart > yStart) ? item->yStart : yStart;
+    int16_t y1 = (item->yEnd < yEnd) ? item->yEnd : yEnd;
+    uint16_t pixel = LCD_PIXEL(item->color);
+    int16_t x = 0;
+    int16_t y = 0;
+
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+
+    switch (item->type)
+    {
+    case LCD_SCENE_RECT:
+        for (y = y0; y < y1; y++)
+        {
+            uint16_t *row = &stripBuffer[(y - yStart) * width - xStart];
+            for (x = x0; x < x1; x++)
+            {
+                row[x] = pixel;
+            }
+        }
+        break;
+
+    case LCD_SCENE_BITMAP:
+        for (y = y0; y < y1; y++)
+        {
+            const uint16_t *source = &item->data.pixels[(y - item->yStart) * (item->xEnd - item->xStart) - item->xStart];
+            memcpy(&stripBuffer[(y - yStart) * width + x0 - xStart], &source[x0], 2 * (x1 - x0));
+        }
+        break;
+
+    case LCD_SCENE_TEXT:
+    {
+        /* only the characters that reach into the strip are looked up */
+        int16_t first = (x0 - item->xStart) / LCD_FONT_WIDTH;
+        int16_t last = (x1 - 1 - item->xStart) / LCD_FONT_WIDTH;
+        int16_t c = 0;
+        uint8_t glyph[LCD_FONT_HEIGHT];
+
+        for (c = first; c <= last; c++)
+        {
+            int16_t charX = item->xStart + c * LCD_FONT_WIDTH;
+            int16_t cx0 = (charX > x0) ? charX : x0;
+            int16_t cx1 = (charX + LCD_FONT_WIDTH < x1) ? charX + LCD_FONT_WIDTH : x1;
+
+            GetASCIICode(glyph, item->data.text[c]);
+
+            for (y = y0; y < y1; y++)
+            {
+                uint8_t bits = glyph[y - item->yStart];
+                uint16_t *row = &stripBuffer[(y - yStart) * width - xStart];
+                for (x = cx0; x < cx1; x++)
+                {
+                    if ((bits >> (7 - (x - charX))) & 0x01)
+                    {
+                        row[x] = pixel;
+                    }
+                }
+            }
+        }
+        break;
+    }
+    }
+}
+
+/************************************  Private Functions  *******************************************/
+
+
+/************************************  Public Functions  *******************************************/
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneInit
+ * Description    : Empties a scene
+ * Input          : scene, background: color under all items
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_SceneInit(LCD_Scene *scene, uint16_t background)
+{
+    scene->background = background;
+    scene->numberOfItems = 0;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddRect
+ * Description    : Adds a filled rectangle on top of the scene
+ * Input          : scene, xStart, xEnd, yStart, yEnd, Color
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : None
+ *******************************************************************************/
+bool LCD_SceneAddRect(LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t Color)
+{
+    LCD_SceneItem *item = LCD_SceneAdd(scene, LCD_SCENE_RECT, xStart, xEnd, yStart, yEnd);
+
+    if (item == 0)
+    {
+        return false;
+    }
+
+    item->color = Color;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddBitmap
+ * Description    : Adds a bitmap on top of the scene
+ * Input          : scene, xStart, xEnd, yStart, yEnd, pixels: (xEnd-xStart)*(yEnd-yStart) pixels, row by row
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : Pixels must be in LCD byte order (LCD_PIXEL), same as LCD_DrawBitmap
+ *******************************************************************************/
+bool LCD_SceneAddBitmap(LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels)
+{
+    LCD_SceneItem *item = LCD_SceneAdd(scene, LCD_SCENE_BITMAP, xStart, xEnd, yStart, yEnd);
+
+    if (item == 0)
+    {
+        return false;
+    }
+
+    item->data.pixels = pixels;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SceneAddText
+ * Description    : Adds a string on top of the scene, only the glyph pixels cover what is below
+ * Input          : scene, Xpos, Ypos: top left of the first character, str, Color
+ * Output         : None
+ * Return         : false if the scene is full
+ * Attention      : Does not wrap like LCD_Text, characters past the screen edge are cut
+ *******************************************************************************/
+bool LCD_SceneAddText(LCD_Scene *scene, int16_t Xpos, int16_t Ypos, const char *str, uint16_t Color)
+{
+    LCD_SceneItem *item = LCD_SceneAdd(scene, LCD_SCENE_TEXT, Xpos, Xpos + LCD_FONT_WIDTH * strlen(str), Ypos, Ypos + LCD_FONT_HEIGHT);
+
+    if (item == 0)
+    {
+        return false;
+    }
+
+    item->color = Color;
+    item->data.text = str;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_RenderScene
+ * Description    : Renders part of a scene strip by strip and sends every strip in one burst
+ * Input          : scene, xStart, xEnd, yStart, yEnd: region to redraw, cut to the screen
+ * Output         : None
+ * Return         : None
+ * Attention      : Items outside of the region are not drawn, pass the whole screen to draw everything
+ *******************************************************************************/
+void LCD_RenderScene(const LCD_Scene *scene, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd)
+{
+    uint16_t background = LCD_PIXEL(scene->background);
+    int16_t lines = 0;
+    int16_t y = 0;
+    uint32_t i = 0;
+
+    xStart = (xStart < MIN_SCREEN_X) ? MIN_SCREEN_X : xStart;
+    xEnd = (xEnd > MAX_SCREEN_X) ? MAX_SCREEN_X : xEnd;
+    yStart = (yStart < MIN_SCREEN_Y) ? MIN_SCREEN_Y : yStart;
+    yEnd = (yEnd > MAX_SCREEN_Y) ? MAX_SCREEN_Y : yEnd;
+
+    if (xStart >= xEnd || yStart >= yEnd)
+    {
+        return;
+    }
+
+    lines = LCD_STRIP_PIXELS / (xEnd - xStart);
+
+    for (y = yStart; y < yEnd; y += lines)
+    {
+        int16_t stripEnd = (y + lines < yEnd) ? y + lines : yEnd;
+        uint32_t count = (xEnd - xStart) * (stripEnd - y);
+
+        for (i = 0; i < count; i++)
+        {
+            stripBuffer[i] = background;
+        }
+
+        for (i = 0; i < scene->numberOfItems; i++)
+        {
+            LCD_renderItem(&scene->items[i], xStart, xEnd, y, stripEnd);
+        }
+
+        LCD_DrawBitmap(xStart, xEnd, y, stripEnd, stripBuffer);
+    }
+}
+
+/************************************  Public Functions  *******************************************/
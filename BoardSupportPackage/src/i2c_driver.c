@@ -112,6 +112,16 @@ void initI2C(void)
 //    MAP_I2C_initMaster(EUSCI_B1_BASE, &i2cConfig);
 }
 
+/***********************************************************
+  Function:
+  	  SMCLK has changed, every transfer re-initializes the master
+  	  from i2cConfig so the next one picks up the new divider
+*/
+void updateI2CClock(uint32_t ui32ClkFreq)
+{
+	i2cConfig.i2cClk = ui32ClkFreq;
+}
+
 /***********************************************************
   Function:
 */
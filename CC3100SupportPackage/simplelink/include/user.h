@@ -669,27 +669,31 @@ typedef P_EVENT_HANDLER                         SL_P_EVENT_HANDLER;
 
 #ifdef SL_MEMORY_MGMT_DYNAMIC
 
+#include "G8RTOS_Memory.h"
+
 /*!
-    \brief
+    \brief         Allocates from the G8RTOS fixed-block pools
 
-    \sa
+    \sa            G8RTOS_Malloc
 
     \note           belongs to \ref porting_sec
 
-    \warning        
+    \warning        A pool with blocks of at least sizeof(_SlDriverCb_t) and one
+                    with blocks of at least SL_ASYNC_MAX_MSG_LEN must be registered
+                    with G8RTOS_RegisterPool before sl_Start is called
 */
-#define sl_Malloc(Size)
+#define sl_Malloc(Size)                                 G8RTOS_Malloc(Size)
 
 /*!
-    \brief
+    \brief         Returns a block to the G8RTOS fixed-block pool that owns it
 
-    \sa
+    \sa            G8RTOS_Free
 
     \note           belongs to \ref porting_sec
 
     \warning        
 */
-#define sl_Free(pMem)
+#define sl_Free(pMem)                                   G8RTOS_Free(pMem)
 
 #endif
 
@@ -40,6 +40,7 @@
 #include "simplelink.h"
 #include "spi_cc3100.h"
 #include "board.h"
+#include "RamFunc.h"
 
 //MSP430F5529
 //#define ASSERT_CS()          (P2OUT &= ~BIT2)
@@ -105,7 +106,7 @@ Fd_t spi_Open(char *ifName, unsigned long flags)
 }
 
 
-int spi_Write(Fd_t fd, unsigned char *pBuff, int len)
+RAMFUNC int spi_Write(Fd_t fd, unsigned char *pBuff, int len)
 {
         int len_to_return = len;
 
@@ -126,7 +127,7 @@ int spi_Write(Fd_t fd, unsigned char *pBuff, int len)
 }
 
 
-int spi_Read(Fd_t fd, unsigned char *pBuff, int len)
+RAMFUNC int spi_Read(Fd_t fd, unsigned char *pBuff, int len)
 {
     int i = 0;
 
@@ -9,5 +9,19 @@
 #include "G8RTOS_Semaphores.h"
 #include "G8RTOS_Scheduler.h"
 #include "G8RTOS_IPC.h"
+#include "G8RTOS_Memory.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_Supervisor.h"
+#include "G8RTOS_Governor.h"
+#include "G8RTOS_Shell.h"
+#include "G8RTOS_IrqProfile.h"
+#include "G8RTOS_Coroutine.h"
+#include "G8RTOS_Benchmark.h"
+#include "G8RTOS_MPU.h"
+#include "G8RTOS_Dispatch.h"
+#include "G8RTOS_Background.h"
+#include "G8RTOS_Display.h"
+#include "G8RTOS_Compositor.h"
+#include "G8RTOS_Static.h"
 
 #endif /* G8RTOS_H_ */
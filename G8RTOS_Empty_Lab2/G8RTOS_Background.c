@@ -0,0 +1,194 @@
+/*
+ * G8RTOS_Background.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_Background.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Background job, the slot is free while work is 0
+ */
+typedef struct background_job_t {
+    bool (*work)(void *arg);
+    void *arg;
+    uint8_t budget;
+    uint32_t limitCycles;
+    uint32_t usedCycles;
+} background_job_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+static background_job_t jobs[MAX_BACKGROUND_JOBS];
+static uint32_t NumberOfBackgroundJobs = 0;
+static uint32_t BackgroundCycles = 0;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Cycles a budget of budget percent allows in one window, at the current clock
+ */
+static uint32_t BudgetCycles(uint8_t budget)
+{
+    return (ClockSys_GetSysFreq() / 1000) * BACKGROUND_WINDOW / 100 * budget;
+}
+
+/*
+ * Starts a new window, every job gets its full budget again
+ *  - The governor may have changed the clock, so the limits are recomputed
+ */
+static void NewWindow()
+{
+    uint32_t i = 0;
+
+    int32_t IBit_State = StartCriticalSection();
+
+    for (i = 0; i < MAX_BACKGROUND_JOBS; i++)
+    {
+        jobs[i].limitCycles = BudgetCycles(jobs[i].budget);
+        jobs[i].usedCycles = 0;
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Background runner thread
+ *  - Runs one unit of the next job with budget left, round robin, then yields
+ *  - Only this thread frees slots, others only fill free ones
+ */
+static void BackgroundRunner()
+{
+    uint32_t windowEnd = SystemTime + BACKGROUND_WINDOW;
+    uint32_t next = 0;
+    uint32_t i = 0;
+
+    NewWindow();
+
+    while(1)
+    {
+        if (G8RTOS_TimeAfterEq(SystemTime, windowEnd))
+        {
+            windowEnd = SystemTime + BACKGROUND_WINDOW;
+            NewWindow();
+        }
+
+        background_job_t *job = 0;
+        for (i = 0; i < MAX_BACKGROUND_JOBS && job == 0; i++)
+        {
+            background_job_t *candidate = &jobs[(next + i) % MAX_BACKGROUND_JOBS];
+            if (candidate->work != 0 && candidate->usedCycles < candidate->limitCycles)
+            {
+                job = candidate;
+                next = (next + i + 1) % MAX_BACKGROUND_JOBS;
+            }
+        }
+
+        /* nothing to do until the next interrupt, SysTick at the latest */
+        if (job == 0)
+        {
+            asm("   WFI ");
+            continue;
+        }
+
+        uint32_t start = DWT->CYCCNT;
+        bool more = job->work(job->arg);
+        uint32_t cycles = DWT->CYCCNT - start;
+
+        job->usedCycles += cycles;
+        BackgroundCycles += cycles;
+
+        if (!more)
+        {
+            int32_t IBit_State = StartCriticalSection();
+            job->work = 0;
+            NumberOfBackgroundJobs--;
+            EndCriticalSection(IBit_State);
+        }
+
+        /* yield point between units */
+        yield();
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the runner thread at IDLE_PRIORITY
+ */
+sched_ErrCode_t G8RTOS_StartBackgroundJobs()
+{
+    return G8RTOS_AddThread(BackgroundRunner, IDLE_PRIORITY, "background");
+}
+
+/*
+ * Adds a background job
+ */
+sched_ErrCode_t G8RTOS_AddBackgroundJob(bool (*work)(void *arg), void *arg, uint8_t budget)
+{
+    uint32_t i = 0;
+
+    if (budget == 0 || budget > 100)
+    {
+        return BUDGET_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    for (i = 0; i < MAX_BACKGROUND_JOBS && jobs[i].work != 0; i++);
+
+    if (i == MAX_BACKGROUND_JOBS)
+    {
+        EndCriticalSection(IBit_State);
+        return REGISTRY_FULL;
+    }
+
+    jobs[i].arg = arg;
+    jobs[i].budget = budget;
+    jobs[i].limitCycles = BudgetCycles(budget);
+    jobs[i].usedCycles = 0;
+    jobs[i].work = work;
+    NumberOfBackgroundJobs++;
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Returns the number of jobs that are not done
+ */
+uint32_t G8RTOS_GetNumberOfBackgroundJobs()
+{
+    return NumberOfBackgroundJobs;
+}
+
+/*
+ * Returns the cycles spent in background jobs since launch
+ */
+uint32_t G8RTOS_GetBackgroundCycles()
+{
+    return BackgroundCycles;
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,63 @@
+/*
+ * G8RTOS_Background.h
+ *
+ * Background jobs run in idle time
+ *  - The runner thread has IDLE_PRIORITY, so jobs only run when no other thread is ready, and it replaces the idle thread:
+ *    with no job left, or every job over its budget, it waits for the next interrupt with WFI
+ *  - A job is a function that does one unit of work per call (flush one log page, checksum one flash block,
+ *    render one glyph) and returns true while work is left. Units should take well under a millisecond
+ *  - The runner yields after every unit, ready threads preempt it at the next SysTick as usual
+ *  - Every job has a budget, a percentage of the cycles of each BACKGROUND_WINDOW ms.
+ *    A unit is charged its cycles from start to end, including time it was preempted, so the budget errs towards less work
+ *  - Cycles spent in background jobs count as idle for G8RTOS_GetIdleCycles and the governor
+ */
+
+#ifndef G8RTOS_BACKGROUND_H_
+#define G8RTOS_BACKGROUND_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Maximum number of jobs waiting or running */
+#define MAX_BACKGROUND_JOBS 8
+
+/* Length of a budget window in ms */
+#define BACKGROUND_WINDOW 100
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the runner thread at IDLE_PRIORITY
+ * Returns: Error code for adding the thread
+ */
+sched_ErrCode_t G8RTOS_StartBackgroundJobs();
+
+/*
+ * Adds a background job
+ *  - Can be called from threads and interrupts, before or after G8RTOS_Launch
+ * Param "work": Does one unit of work, returns false when the job is done
+ * Param "arg": Passed to every call of work
+ * Param "budget": Percentage of every window the job may use, 1 to 100
+ * Returns: BUDGET_INVALID, or REGISTRY_FULL if MAX_BACKGROUND_JOBS are waiting
+ */
+sched_ErrCode_t G8RTOS_AddBackgroundJob(bool (*work)(void *arg), void *arg, uint8_t budget);
+
+/*
+ * Returns the number of jobs that are not done
+ */
+uint32_t G8RTOS_GetNumberOfBackgroundJobs();
+
+/*
+ * Returns the cycles spent in background jobs since launch, wraps
+ */
+uint32_t G8RTOS_GetBackgroundCycles();
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_BACKGROUND_H_ */
@@ -0,0 +1,245 @@
+/*
+ * G8RTOS_Benchmark.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "BSP.h"
+#include "RamFunc.h"
+#include "G8RTOS_Benchmark.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_IrqProfile.h"
+
+/* Defined in G8RTOS_Scheduler.c */
+extern tcb_t * CurrentlyRunningThread;
+extern void G8RTOS_Scheduler();
+#ifdef G8RTOS_MPU
+extern void G8RTOS_SwitchStackRegion();
+#endif
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+#define BENCHMARK_OUTPUT_LENGTH 64
+
+static uint32_t benchmarkData[BENCHMARK_WORDS];
+
+/* Test image in every sprite format, vertical stripes BENCHMARK_STRIPE pixels wide */
+#define BENCHMARK_STRIPE 4
+#define BENCHMARK_PIXELS (BENCHMARK_FILL_SIZE * BENCHMARK_FILL_SIZE)
+
+static const uint16_t benchmarkPalette[4] = { LCD_RED, LCD_GREEN, LCD_BLUE, LCD_WHITE };
+static uint16_t benchmarkRaw[BENCHMARK_PIXELS];
+static uint16_t benchmarkBitmap[BENCHMARK_PIXELS];
+static uint8_t benchmarkIndices[BENCHMARK_PIXELS];
+static uint16_t benchmarkRLE[2 * BENCHMARK_PIXELS / BENCHMARK_STRIPE];
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * CPU bound loop, shows the flash wait states without any peripheral in the way
+ */
+static RAMFUNC uint32_t Checksum(const uint32_t *data, uint32_t length)
+{
+    uint32_t sum = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        sum = (sum << 1) + (sum >> 31) + data[i];
+    }
+
+    return sum;
+}
+
+/*
+ * Average cycles of one G8RTOS_Scheduler call
+ *  - The chosen thread is put back after every call, the cycles are charged to the calling thread
+ */
+static uint32_t BenchmarkScheduler()
+{
+    uint32_t i = 0;
+
+    int32_t IBit_State = StartCriticalSection();
+
+    tcb_t *caller = CurrentlyRunningThread;
+    uint32_t start = DWT->CYCCNT;
+
+    for (i = 0; i < BENCHMARK_RUNS; i++)
+    {
+        G8RTOS_Scheduler();
+        CurrentlyRunningThread = caller;
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    EndCriticalSection(IBit_State);
+
+    return cycles / BENCHMARK_RUNS;
+}
+
+#ifdef G8RTOS_MPU
+/*
+ * Average cycles of the stack region update PendSV_Handler makes for every switch
+ *  - Maps the calling thread's own stack again, so nothing changes
+ */
+static uint32_t BenchmarkMPUSwitch()
+{
+    uint32_t i = 0;
+
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t start = DWT->CYCCNT;
+
+    for (i = 0; i < BENCHMARK_RUNS; i++)
+    {
+        G8RTOS_SwitchStackRegion();
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    EndCriticalSection(IBit_State);
+
+    return cycles / BENCHMARK_RUNS;
+}
+#endif
+
+/*
+ * Builds the test image in every format
+ */
+static void BuildSprites(LCD_Sprite *sprites)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < BENCHMARK_PIXELS; i++)
+    {
+        benchmarkIndices[i] = (i / BENCHMARK_STRIPE) % 4;
+        benchmarkRaw[i] = benchmarkPalette[benchmarkIndices[i]];
+        benchmarkBitmap[i] = LCD_PIXEL(benchmarkRaw[i]);
+    }
+
+    for (i = 0; i < BENCHMARK_PIXELS / BENCHMARK_STRIPE; i++)
+    {
+        benchmarkRLE[2*i] = BENCHMARK_STRIPE;
+        benchmarkRLE[2*i + 1] = benchmarkRaw[i * BENCHMARK_STRIPE];
+    }
+
+    for (i = LCD_SPRITE_RAW; i <= LCD_SPRITE_RLE; i++)
+    {
+        sprites[i].width = BENCHMARK_FILL_SIZE;
+        sprites[i].height = BENCHMARK_FILL_SIZE;
+        sprites[i].format = i;
+        sprites[i].keyed = false;
+        sprites[i].key = 0;
+        sprites[i].palette = benchmarkPalette;
+    }
+    sprites[LCD_SPRITE_RAW].data = benchmarkRaw;
+    sprites[LCD_SPRITE_PAL8].data = benchmarkIndices;
+    sprites[LCD_SPRITE_RLE].data = benchmarkRLE;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Measures the RAMFUNC code paths and writes the results to the back channel UART
+ */
+void G8RTOS_RunBenchmark(benchmark_result_t *result)
+{
+    benchmark_result_t r;
+    char output[BENCHMARK_OUTPUT_LENGTH];
+    uint32_t i = 0;
+
+    for (i = 0; i < BENCHMARK_WORDS; i++)
+    {
+        benchmarkData[i] = i * 0x9E3779B9;
+    }
+
+    /* checksum */
+    uint32_t start = DWT->CYCCNT;
+    for (i = 0; i < BENCHMARK_RUNS; i++)
+    {
+        benchmarkData[0] += Checksum(benchmarkData, BENCHMARK_WORDS);
+    }
+    r.loopCycles = (DWT->CYCCNT - start) / BENCHMARK_RUNS;
+
+    /* scheduler */
+    r.schedulerCycles = BenchmarkScheduler();
+
+    /* MPU stack region */
+#ifdef G8RTOS_MPU
+    r.mpuSwitchCycles = BenchmarkMPUSwitch();
+#else
+    r.mpuSwitchCycles = 0;
+#endif
+
+    /* LCD fill through SPISendRecvByte */
+    start = DWT->CYCCNT;
+    LCD_DrawRectangle(0, BENCHMARK_FILL_SIZE, 0, BENCHMARK_FILL_SIZE, LCD_BLACK);
+    r.fillCyclesPerPixel = (DWT->CYCCNT - start) / (BENCHMARK_FILL_SIZE * BENCHMARK_FILL_SIZE);
+
+    /* sprite decoding against the raw transfer of the same pixels */
+    LCD_Sprite sprites[LCD_SPRITE_RLE + 1];
+    BuildSprites(sprites);
+
+    start = DWT->CYCCNT;
+    LCD_DrawBitmap(0, BENCHMARK_FILL_SIZE, 0, BENCHMARK_FILL_SIZE, benchmarkBitmap);
+    r.bitmapCyclesPerPixel = (DWT->CYCCNT - start) / BENCHMARK_PIXELS;
+
+    for (i = LCD_SPRITE_RAW; i <= LCD_SPRITE_RLE; i++)
+    {
+        start = DWT->CYCCNT;
+        LCD_DrawSprite(&sprites[i], 0, 0);
+        r.spriteCyclesPerPixel[i] = (DWT->CYCCNT - start) / BENCHMARK_PIXELS;
+    }
+
+#ifdef USE_RAMFUNC
+    BackChannelWrite("benchmark: code in SRAM\r\n");
+#else
+    BackChannelWrite("benchmark: code in flash\r\n");
+#endif
+
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "checksum  %u cyc\r\n", (unsigned int)r.loopCycles);
+    BackChannelWrite(output);
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "scheduler %u cyc\r\n", (unsigned int)r.schedulerCycles);
+    BackChannelWrite(output);
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "lcd fill  %u cyc/px\r\n", (unsigned int)r.fillCyclesPerPixel);
+    BackChannelWrite(output);
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "bitmap    %u cyc/px\r\n", (unsigned int)r.bitmapCyclesPerPixel);
+    BackChannelWrite(output);
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "sprite    raw %u pal8 %u rle %u cyc/px\r\n", (unsigned int)r.spriteCyclesPerPixel[LCD_SPRITE_RAW],
+             (unsigned int)r.spriteCyclesPerPixel[LCD_SPRITE_PAL8], (unsigned int)r.spriteCyclesPerPixel[LCD_SPRITE_RLE]);
+    BackChannelWrite(output);
+
+#ifdef G8RTOS_MPU
+    snprintf(output, BENCHMARK_OUTPUT_LENGTH, "mpu       %u cyc/switch\r\n", (unsigned int)r.mpuSwitchCycles);
+    BackChannelWrite(output);
+#endif
+
+#ifdef G8RTOS_IRQ_PROFILE
+    irq_stats_t stats;
+    if (G8RTOS_GetIrqStats(SysTick_IRQn, &stats) == NO_ERROR)
+    {
+        snprintf(output, BENCHMARK_OUTPUT_LENGTH, "systick   %u cyc worst\r\n", (unsigned int)stats.worstDuration);
+        BackChannelWrite(output);
+    }
+#endif
+
+    if (result)
+    {
+        *result = r;
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
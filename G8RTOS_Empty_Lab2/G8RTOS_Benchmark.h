@@ -0,0 +1,60 @@
+/*
+ * G8RTOS_Benchmark.h
+ *
+ * Cycle counts of the code paths that USE_RAMFUNC moves into SRAM
+ *  - Run the same benchmark on a build with and without USE_RAMFUNC to compare flash and SRAM execution
+ *  - SysTick_Handler is measured by the IRQ profiler when G8RTOS_IRQ_PROFILE is also defined
+ *  - With G8RTOS_MPU the cost the MPU adds to every context switch is measured as well
+ *  - Sprite drawing is measured for every LCDSprite format against LCD_DrawBitmap of the same pixels, the raw transfer
+ *  - PendSV_Handler can not be called directly, and the CC3100 SPI loops are not run so no bytes reach the CC3100
+ */
+
+#ifndef G8RTOS_BENCHMARK_H_
+#define G8RTOS_BENCHMARK_H_
+
+#include <stdint.h>
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Repetitions that are averaged for every measurement */
+#define BENCHMARK_RUNS 64
+
+/* Words summed by the CPU bound loop */
+#define BENCHMARK_WORDS 256
+
+/* Side of the square filled in the top left corner of the LCD */
+#define BENCHMARK_FILL_SIZE 16
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Results in MCLK cycles
+ */
+typedef struct benchmark_result_t {
+    uint32_t loopCycles;            // BENCHMARK_WORDS word checksum
+    uint32_t schedulerCycles;       // one G8RTOS_Scheduler call
+    uint32_t fillCyclesPerPixel;    // LCD_DrawRectangle, includes waiting for the SPI
+    uint32_t mpuSwitchCycles;       // stack region update added to every context switch, 0 without G8RTOS_MPU
+    uint32_t bitmapCyclesPerPixel;  // LCD_DrawBitmap, pixels already in LCD byte order
+    uint32_t spriteCyclesPerPixel[3];   // LCD_DrawSprite, indexed by LCD_SpriteFormat
+} benchmark_result_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Measures the RAMFUNC code paths and writes the results to the back channel UART
+ *  - Must be called from a thread after G8RTOS_Launch, interrupts are masked while the scheduler is measured
+ *  - Draws BENCHMARK_FILL_SIZE squares in the top left corner of the LCD, the caller must own the LCD
+ * Param "result": Filled with the results, may be 0
+ */
+void G8RTOS_RunBenchmark(benchmark_result_t *result);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_BENCHMARK_H_ */
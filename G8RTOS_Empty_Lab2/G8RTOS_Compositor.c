@@ -0,0 +1,342 @@
+/*
+ * G8RTOS_Compositor.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_Compositor.h"
+#include "G8RTOS_Display.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Objects from bottom to top */
+static display_object_t *objects = 0;
+static uint16_t backgroundColor = 0;
+
+static display_rect_t dirty[MAX_DIRTY_RECTS];
+static uint32_t numberOfDirty = 0;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+static bool IsEmpty(const display_rect_t *a)
+{
+    return (a->xStart >= a->xEnd || a->yStart >= a->yEnd);
+}
+
+static bool Overlaps(const display_rect_t *a, const display_rect_t *b)
+{
+    return (a->xStart < b->xEnd && b->xStart < a->xEnd && a->yStart < b->yEnd && b->yStart < a->yEnd);
+}
+
+/*
+ * Returns: true if a covers all of b
+ */
+static bool Covers(const display_rect_t *a, const display_rect_t *b)
+{
+    return (a->xStart <= b->xStart && a->xEnd >= b->xEnd && a->yStart <= b->yStart && a->yEnd >= b->yEnd);
+}
+
+/*
+ * Intersection of a and b
+ * Returns: false if it is empty
+ */
+static bool Intersect(const display_rect_t *a, const display_rect_t *b, display_rect_t *out)
+{
+    out->xStart = (a->xStart > b->xStart) ? a->xStart : b->xStart;
+    out->xEnd = (a->xEnd < b->xEnd) ? a->xEnd : b->xEnd;
+    out->yStart = (a->yStart > b->yStart) ? a->yStart : b->yStart;
+    out->yEnd = (a->yEnd < b->yEnd) ? a->yEnd : b->yEnd;
+
+    return !IsEmpty(out);
+}
+
+/*
+ * Grows a to cover b as well
+ */
+static void Union(display_rect_t *a, const display_rect_t *b)
+{
+    a->xStart = (a->xStart < b->xStart) ? a->xStart : b->xStart;
+    a->xEnd = (a->xEnd > b->xEnd) ? a->xEnd : b->xEnd;
+    a->yStart = (a->yStart < b->yStart) ? a->yStart : b->yStart;
+    a->yEnd = (a->yEnd > b->yEnd) ? a->yEnd : b->yEnd;
+}
+
+/*
+ * Adds a dirty rectangle, merging it with every dirty rectangle it overlaps
+ */
+static void AddDirty(display_rect_t rect)
+{
+    uint32_t i = 0;
+
+    if (IsEmpty(&rect))
+    {
+        return;
+    }
+
+    /* the merged rectangle can overlap ones the original did not, so start over after each merge */
+    while (i < numberOfDirty)
+    {
+        if (Overlaps(&rect, &dirty[i]))
+        {
+            Union(&rect, &dirty[i]);
+            dirty[i] = dirty[--numberOfDirty];
+            i = 0;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (numberOfDirty == MAX_DIRTY_RECTS)
+    {
+        Union(&rect, &dirty[--numberOfDirty]);
+        AddDirty(rect);
+        return;
+    }
+
+    dirty[numberOfDirty++] = rect;
+}
+
+/*
+ * Adds the part of a that b does not cover, as up to four strips
+ */
+static void AddDifference(const display_rect_t *a, const display_rect_t *b)
+{
+    display_rect_t middle;
+    display_rect_t strip;
+
+    if (!Intersect(a, b, &middle))
+    {
+        AddDirty(*a);
+        return;
+    }
+
+    /* above and below b, full width of a */
+    strip = *a;
+    strip.yEnd = middle.yStart;
+    AddDirty(strip);
+
+    strip = *a;
+    strip.yStart = middle.yEnd;
+    AddDirty(strip);
+
+    /* left and right of b, rows b shares with a */
+    strip = middle;
+    strip.xStart = a->xStart;
+    strip.xEnd = middle.xStart;
+    AddDirty(strip);
+
+    strip = middle;
+    strip.xStart = middle.xEnd;
+    strip.xEnd = a->xEnd;
+    AddDirty(strip);
+}
+
+/*
+ * Queues a fill clipped to the screen
+ * Returns: Pixels queued
+ */
+static uint32_t Fill(const display_rect_t *area, uint16_t color)
+{
+    static const display_rect_t screen = { 0, MAX_SCREEN_X, 0, MAX_SCREEN_Y };
+    display_rect_t part;
+
+    if (!Intersect(area, &screen, &part))
+    {
+        return 0;
+    }
+
+    /* a dropped fill would leave a stale strip on screen, so wait for the render thread to make room */
+    while (G8RTOS_DisplayFillRect(part.xStart, part.xEnd, part.yStart, part.yEnd, color) == QUEUE_FULL)
+    {
+        sleep(1);
+    }
+
+    return (uint32_t)(part.xEnd - part.xStart) * (part.yEnd - part.yStart);
+}
+
+/*
+ * Paints a dirty rectangle bottom to top
+ * Returns: Pixels queued
+ */
+static uint32_t Compose(const display_rect_t *area)
+{
+    display_object_t *object = 0;
+    display_object_t *base = 0;
+    display_rect_t part;
+    uint32_t pixels = 0;
+
+    /* the top-most object covering the whole area hides the background and everything below it */
+    for (object = objects; object; object = object->next)
+    {
+        if (object->drawn && Covers(&object->drawnRect, area))
+        {
+            base = object;
+        }
+    }
+
+    if (base == 0)
+    {
+        pixels += Fill(area, backgroundColor);
+        base = objects;
+    }
+
+    for (object = base; object; object = object->next)
+    {
+        if (object->drawn && Intersect(&object->drawnRect, area, &part))
+        {
+            pixels += Fill(&part, object->drawnColor);
+        }
+    }
+
+    return pixels;
+}
+
+/*
+ * Adds what changed on an object since it was drawn and marks it drawn
+ */
+static void Update(display_object_t *object)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    display_rect_t rect = object->rect;
+    uint16_t color = object->color;
+    bool visible = object->visible;
+
+    EndCriticalSection(IBit_State);
+
+    display_rect_t *old = &object->drawnRect;
+
+    if (!object->drawn && !visible)
+    {
+        return;
+    }
+
+    if (object->drawn && visible && color == object->drawnColor)
+    {
+        /* a moved object only changes where the old and new rectangles differ */
+        AddDifference(old, &rect);
+        AddDifference(&rect, old);
+    }
+    else
+    {
+        if (object->drawn)
+        {
+            AddDirty(*old);
+        }
+        if (visible)
+        {
+            AddDirty(rect);
+        }
+    }
+
+    object->drawnRect = rect;
+    object->drawnColor = color;
+    object->drawn = visible;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Sets the background color
+ */
+void G8RTOS_InitCompositor(uint16_t background)
+{
+    objects = 0;
+    backgroundColor = background;
+}
+
+/*
+ * Adds an object on top of the others
+ */
+void G8RTOS_AddDisplayObject(display_object_t *object, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t color)
+{
+    display_object_t **link = &objects;
+
+    object->rect.xStart = xStart;
+    object->rect.xEnd = xEnd;
+    object->rect.yStart = yStart;
+    object->rect.yEnd = yEnd;
+    object->color = color;
+    object->visible = true;
+    object->drawn = false;
+    object->next = 0;
+
+    while (*link)
+    {
+        link = &(*link)->next;
+    }
+    *link = object;
+}
+
+/*
+ * Moves an object, keeping its size
+ */
+void G8RTOS_MoveDisplayObject(display_object_t *object, int16_t xStart, int16_t yStart)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    object->rect.xEnd += xStart - object->rect.xStart;
+    object->rect.yEnd += yStart - object->rect.yStart;
+    object->rect.xStart = xStart;
+    object->rect.yStart = yStart;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Changes the color of an object
+ */
+void G8RTOS_SetDisplayObjectColor(display_object_t *object, uint16_t color)
+{
+    object->color = color;
+}
+
+/*
+ * Shows or hides an object
+ */
+void G8RTOS_ShowDisplayObject(display_object_t *object, bool visible)
+{
+    object->visible = visible;
+}
+
+/*
+ * Queues the fills that bring the screen up to date with the objects
+ */
+uint32_t G8RTOS_ComposeFrame()
+{
+    display_object_t *object = 0;
+    uint32_t pixels = 0;
+    uint32_t i = 0;
+
+    numberOfDirty = 0;
+
+    for (object = objects; object; object = object->next)
+    {
+        Update(object);
+    }
+
+    for (i = 0; i < numberOfDirty; i++)
+    {
+        pixels += Compose(&dirty[i]);
+    }
+
+    return pixels;
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,100 @@
+/*
+ * G8RTOS_Compositor.h
+ *
+ * Minimal redraw of solid rectangles (paddles, balls, cursors) on a solid background
+ *  - Threads move, recolor, show and hide objects, one thread calls G8RTOS_ComposeFrame once per frame
+ *  - The compositor keeps what each object looked like when it was last drawn. An object that moved
+ *    only dirties the strip it left and the strip it now covers, an unchanged object dirties nothing
+ *  - Overlapping dirty rectangles are merged, then every dirty rectangle is painted bottom to top:
+ *    background, then every object in the order they were added, each clipped to the rectangle.
+ *    Objects below the top-most object that covers a whole dirty rectangle are skipped
+ *  - Painting goes through the render queue of G8RTOS_Display, G8RTOS_StartDisplay must have been called
+ *
+ *  A 64 x 4 paddle moving 2 pixels costs 16 pixels instead of the 512 of erasing and redrawing it
+ */
+
+#ifndef G8RTOS_COMPOSITOR_H_
+#define G8RTOS_COMPOSITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Dirty rectangles of one frame after merging, further ones are merged into the last */
+#define MAX_DIRTY_RECTS 16
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Rectangle with exclusive ends, same as LCD_DrawRectangle
+ */
+typedef struct display_rect_t {
+    int16_t xStart;
+    int16_t xEnd;
+    int16_t yStart;
+    int16_t yEnd;
+} display_rect_t;
+
+/*
+ * Object on screen
+ *  - Storage belongs to the caller, e.g. one static entry per paddle and ball
+ *  - Only change it through the G8RTOS_Compositor functions
+ */
+typedef struct display_object_t display_object_t;
+
+struct display_object_t {
+    display_rect_t rect;
+    uint16_t color;
+    bool visible;
+    display_rect_t drawnRect;
+    uint16_t drawnColor;
+    bool drawn;
+    display_object_t *next;
+};
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Sets the background color, the screen is assumed to be cleared to it
+ */
+void G8RTOS_InitCompositor(uint16_t background);
+
+/*
+ * Adds an object on top of the others, it is drawn by the next frame
+ *  - Call before the composing thread runs, or from it
+ */
+void G8RTOS_AddDisplayObject(display_object_t *object, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t color);
+
+/*
+ * Moves an object, keeping its size
+ */
+void G8RTOS_MoveDisplayObject(display_object_t *object, int16_t xStart, int16_t yStart);
+
+/*
+ * Changes the color of an object
+ */
+void G8RTOS_SetDisplayObjectColor(display_object_t *object, uint16_t color);
+
+/*
+ * Shows or hides an object, a hidden object is erased by the next frame
+ */
+void G8RTOS_ShowDisplayObject(display_object_t *object, bool visible);
+
+/*
+ * Queues the fills that bring the screen up to date with the objects
+ *  - Call from one thread only
+ * Returns: Pixels queued, the SPI sends two bytes for each
+ */
+uint32_t G8RTOS_ComposeFrame();
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_COMPOSITOR_H_ */
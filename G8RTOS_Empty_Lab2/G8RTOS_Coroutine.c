@@ -0,0 +1,139 @@
+/*
+ * G8RTOS_Coroutine.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "G8RTOS_Coroutine.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Coroutines that have not ended, new ones are added at the head */
+static coroutine_t *coroutines = 0;
+static uint32_t NumberOfCoroutines = 0;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Coroutine runner thread
+ *  - Every pass resumes each coroutine that is not asleep, then sleeps until the next millisecond
+ *  - Only this thread removes coroutines, others only add at the head, so the walk needs no critical section
+ *    except to unlink the head
+ */
+static void CoroutineRunner()
+{
+    while(1)
+    {
+        coroutine_t *previous = 0;
+        coroutine_t *co = coroutines;
+
+        while (co != 0)
+        {
+            coroutine_t *next = co->next;
+
+            if (co->asleep && G8RTOS_TimeAfterEq(SystemTime, co->wakeTime))
+            {
+                co->asleep = false;
+            }
+
+            if (!co->asleep && co->body(co) == COROUTINE_ENDED)
+            {
+                int32_t IBit_State = StartCriticalSection();
+
+                /* a coroutine added during the pass may have become the head */
+                if (previous == 0)
+                {
+                    previous = coroutines;
+                    while (previous != co && previous->next != co)
+                    {
+                        previous = previous->next;
+                    }
+                }
+
+                if (previous == co)
+                {
+                    coroutines = next;
+                    previous = 0;
+                }
+                else
+                {
+                    previous->next = next;
+                }
+                NumberOfCoroutines--;
+
+                EndCriticalSection(IBit_State);
+            }
+            else
+            {
+                previous = co;
+            }
+
+            co = next;
+        }
+
+        sleep(1);
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the thread that runs the coroutines
+ */
+sched_ErrCode_t G8RTOS_StartCoroutines(uint8_t priority)
+{
+    return G8RTOS_AddThread(CoroutineRunner, priority, "coroutines");
+}
+
+/*
+ * Adds a coroutine
+ */
+void G8RTOS_AddCoroutine(coroutine_t *co, uint8_t (*body)(coroutine_t *co), void *arg)
+{
+    co->body = body;
+    co->arg = arg;
+    co->line = 0;
+    co->asleep = false;
+    co->wakeTime = SystemTime;
+    co->eventCount = 0;
+
+    int32_t IBit_State = StartCriticalSection();
+
+    co->next = coroutines;
+    coroutines = co;
+    NumberOfCoroutines++;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Wakes every coroutine waiting on an event
+ */
+void G8RTOS_SignalCoroutineEvent(coroutine_event_t *event)
+{
+    int32_t IBit_State = StartCriticalSection();
+    (*event)++;
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Returns the number of coroutines that have not ended
+ */
+uint32_t G8RTOS_GetNumberOfCoroutines()
+{
+    return NumberOfCoroutines;
+}
+
+/*********************************************** Public Functions *********************************************************************/
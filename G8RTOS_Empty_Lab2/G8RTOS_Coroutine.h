@@ -0,0 +1,141 @@
+/*
+ * G8RTOS_Coroutine.h
+ *
+ * Stackless cooperative coroutines
+ *  - Many small state machines (ball movers, blinkers, animations) run inside one G8RTOS thread and share its stack
+ *  - A coroutine costs a coroutine_t instead of a tcb and a STACKSIZE stack, and switching between them is a function call
+ *  - The coroutine body is a switch on the line it last stopped at, so:
+ *      - Local variables do not survive an await, keep state in the coroutine's own struct (reached through arg)
+ *      - Only one await per source line, and no awaits inside a switch statement of the body
+ *  - The runner polls every coroutine that is not asleep once per millisecond, a coroutine runs until its next await
+ *
+ *      static uint8_t Blink(coroutine_t *co)
+ *      {
+ *          COROUTINE_BEGIN(co);
+ *          while(1)
+ *          {
+ *              COROUTINE_AWAIT_SEMAPHORE(co, &LEDMutex);
+ *              ToggleLED();
+ *              G8RTOS_SignalSemaphore(&LEDMutex);
+ *              COROUTINE_AWAIT_PERIOD(co, 250);
+ *          }
+ *          COROUTINE_END(co);
+ *      }
+ */
+
+#ifndef G8RTOS_COROUTINE_H_
+#define G8RTOS_COROUTINE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_Time.h"
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Returned by a coroutine body */
+#define COROUTINE_WAITING 0
+#define COROUTINE_ENDED 1
+
+/*
+ * Event a coroutine can wait on
+ *  - Counts signals, a waiting coroutine resumes once the count differs from the one it saw when it started waiting
+ */
+typedef volatile uint32_t coroutine_event_t;
+
+/*
+ * Coroutine
+ *  - Storage belongs to the caller, e.g. a static array with one entry per ball
+ */
+typedef struct coroutine_t coroutine_t;
+
+struct coroutine_t {
+    uint8_t (*body)(coroutine_t *co);
+    void *arg;
+    uint16_t line;
+    bool asleep;
+    uint32_t wakeTime;
+    uint32_t eventCount;
+    coroutine_t *next;
+};
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Coroutine Body Macros ****************************************************************/
+
+/* First statement of a coroutine body */
+#define COROUTINE_BEGIN(co) switch ((co)->line) { case 0:
+
+/* Last statement of a coroutine body, the coroutine is removed from the runner */
+#define COROUTINE_END(co) } (co)->line = 0; return COROUTINE_ENDED
+
+/* Ends the coroutine from anywhere in its body */
+#define COROUTINE_EXIT(co) do { (co)->line = 0; return COROUTINE_ENDED; } while (0)
+
+/* Gives the other coroutines a turn, resumes on the next pass of the runner */
+#define COROUTINE_YIELD(co) do { (co)->line = __LINE__; return COROUTINE_WAITING; case __LINE__:; } while (0)
+
+/* Resumes once a condition is true, it is evaluated on every pass of the runner */
+#define COROUTINE_AWAIT(co, condition) \
+    do { (co)->line = __LINE__; case __LINE__: if (!(condition)) { return COROUTINE_WAITING; } } while (0)
+
+/* Resumes after durationMS, the runner does not call the coroutine until then */
+#define COROUTINE_AWAIT_SLEEP(co, durationMS) \
+    do { (co)->wakeTime = SystemTime + (durationMS); (co)->asleep = true; (co)->line = __LINE__; \
+         return COROUTINE_WAITING; case __LINE__:; } while (0)
+
+/*
+ * Resumes periodMS after the previous wake up rather than after now, for fixed rate loops
+ *  - Late wake ups are not caught up, the next one is scheduled a full period after now
+ */
+#define COROUTINE_AWAIT_PERIOD(co, periodMS) \
+    do { (co)->wakeTime += (periodMS); \
+         if (G8RTOS_TimeAfter(SystemTime, (co)->wakeTime)) { (co)->wakeTime = SystemTime + (periodMS); } \
+         (co)->asleep = true; (co)->line = __LINE__; return COROUTINE_WAITING; case __LINE__:; } while (0)
+
+/* Resumes holding the semaphore, the semaphore is only taken when it is free so the runner never blocks */
+#define COROUTINE_AWAIT_SEMAPHORE(co, s) COROUTINE_AWAIT(co, G8RTOS_TryWaitSemaphore(s))
+
+/* Resumes after the next G8RTOS_SignalCoroutineEvent on an event */
+#define COROUTINE_AWAIT_EVENT(co, event) \
+    do { (co)->eventCount = *(event); COROUTINE_AWAIT(co, *(event) != (co)->eventCount); } while (0)
+
+/*********************************************** Coroutine Body Macros ****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the thread that runs the coroutines
+ * Param "priority": Priority of the runner thread
+ * Returns: Error code for adding the thread
+ */
+sched_ErrCode_t G8RTOS_StartCoroutines(uint8_t priority);
+
+/*
+ * Adds a coroutine, it first runs on the next pass of the runner
+ *  - Can be called from threads and from other coroutines
+ * Param "co": Storage of the coroutine, must stay valid until the coroutine ends
+ * Param "body": Coroutine body, returns COROUTINE_WAITING or COROUTINE_ENDED through the macros
+ * Param "arg": Passed to the body as co->arg
+ */
+void G8RTOS_AddCoroutine(coroutine_t *co, uint8_t (*body)(coroutine_t *co), void *arg);
+
+/*
+ * Wakes every coroutine waiting on an event
+ *  - Safe to call from threads, coroutines and ISRs
+ */
+void G8RTOS_SignalCoroutineEvent(coroutine_event_t *event);
+
+/*
+ * Returns the number of coroutines that have not ended
+ */
+uint32_t G8RTOS_GetNumberOfCoroutines();
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_COROUTINE_H_ */
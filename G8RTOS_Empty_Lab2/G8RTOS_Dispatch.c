@@ -0,0 +1,353 @@
+/*
+ * G8RTOS_Dispatch.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "driverlib.h"
+#include "G8RTOS_Dispatch.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_IrqProfile.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Handler in the chain of one interrupt
+ */
+typedef struct irq_chain_node_t {
+    void (*handler)(void);
+    uint8_t priority;
+    struct irq_chain_node_t *next;
+} irq_chain_node_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Number of entries in the vector table, the first 16 are the core exceptions */
+#define NUMBER_OF_VECTORS 57
+#define FIRST_IRQ_VECTOR 16
+#define NUMBER_OF_IRQS (NUMBER_OF_VECTORS - FIRST_IRQ_VECTOR)
+
+/* VTOR needs the table aligned to its size rounded up to a power of two */
+#define VECTOR_TABLE_ALIGNMENT 256
+
+/* Vector table in SRAM, placed at 0x20000000 by msp432p401r.cmd so nothing else is linked over it */
+#pragma DATA_SECTION(ramVectors, ".vtable")
+#pragma DATA_ALIGN(ramVectors, VECTOR_TABLE_ALIGNMENT)
+static uint32_t ramVectors[NUMBER_OF_VECTORS];
+
+/* Vector table the device booted with, restores a vector when its chain is emptied */
+static const uint32_t *bootVectors;
+
+static irq_chain_node_t chainNodes[MAX_IRQ_HANDLERS];
+static irq_chain_node_t *chainOfIRQ[NUMBER_OF_IRQS];
+
+/* Pin handlers, indexed by port - 1 and pin */
+static void (*pinHandlers[NUMBER_OF_GPIO_PORTS][PINS_PER_PORT])(void);
+
+/* PxIV of every port, reading it returns 2 * (pin + 1) of the highest pending pin and clears that flag */
+static const volatile uint16_t * const portVectorRegister[NUMBER_OF_GPIO_PORTS] = {
+    &P1->IV, &P2->IV, &P3->IV, &P4->IV, &P5->IV, &P6->IV
+};
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Dispatches an interrupt with more than one handler
+ *  - The active vector number in ICSR tells which chain to call
+ */
+static void ChainDispatcher()
+{
+    irq_chain_node_t *node = chainOfIRQ[(SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) - FIRST_IRQ_VECTOR];
+
+    while (node)
+    {
+        node->handler();
+        node = node->next;
+    }
+}
+
+/*
+ * Dispatches a GPIO port interrupt to the handlers of its pending pins
+ */
+static void PortDispatcher()
+{
+    uint32_t port = (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) - FIRST_IRQ_VECTOR - PORT1_IRQn;
+    void (**handlers)(void) = pinHandlers[port];
+    uint16_t iv = 0;
+
+    while ((iv = *portVectorRegister[port]) != 0)
+    {
+        void (*handler)(void) = handlers[(iv >> 1) - 1];
+        if (handler)
+        {
+            handler();
+        }
+    }
+}
+
+/*
+ * Sets a vector, behind the profiling wrapper if the vector is profiled
+ */
+static void SetVector(IRQn_Type IRQn, void (*handler)(void))
+{
+#ifdef G8RTOS_IRQ_PROFILE
+    G8RTOS_SetProfiledVector(IRQn, handler);
+#else
+    __NVIC_SetVector(IRQn, (uint32_t)handler);
+#endif
+}
+
+/*
+ * Points the vector of an interrupt at its chain and sets its priority
+ *  - Must be called inside of a critical section
+ */
+static void InstallChain(IRQn_Type IRQn)
+{
+    irq_chain_node_t *head = chainOfIRQ[IRQn];
+
+    if (head == 0)
+    {
+        __NVIC_DisableIRQ(IRQn);
+        SetVector(IRQn, (void (*)(void))bootVectors[IRQn + FIRST_IRQ_VECTOR]);
+        return;
+    }
+
+    SetVector(IRQn, (head->next == 0) ? head->handler : ChainDispatcher);
+    __NVIC_SetPriority(IRQn, head->priority);
+    __NVIC_EnableIRQ(IRQn);
+}
+
+/*
+ * Unlinks a handler from a chain
+ *  - Must be called inside of a critical section
+ * Returns: the unlinked node, 0 if the handler is not in the chain
+ */
+static irq_chain_node_t *Unlink(void (*handler)(void), IRQn_Type IRQn)
+{
+    irq_chain_node_t **link = &chainOfIRQ[IRQn];
+
+    while (*link && (*link)->handler != handler)
+    {
+        link = &(*link)->next;
+    }
+
+    irq_chain_node_t *node = *link;
+    if (node)
+    {
+        *link = node->next;
+    }
+
+    return node;
+}
+
+/*
+ * Links a node into a chain after every node with the same or a lower priority number
+ *  - Must be called inside of a critical section
+ */
+static void Link(irq_chain_node_t *node, IRQn_Type IRQn)
+{
+    irq_chain_node_t **link = &chainOfIRQ[IRQn];
+
+    while (*link && (*link)->priority <= node->priority)
+    {
+        link = &(*link)->next;
+    }
+
+    node->next = *link;
+    *link = node;
+}
+
+/*
+ * Adds a handler to a chain, or lowers its priority number if it is already in the chain
+ *  - Must be called inside of a critical section
+ */
+static sched_ErrCode_t AddToChain(void (*handler)(void), uint8_t priority, IRQn_Type IRQn, bool keepHigher)
+{
+    irq_chain_node_t *node = Unlink(handler, IRQn);
+
+    if (node == 0)
+    {
+        uint32_t i = 0;
+        for (i = 0; i < MAX_IRQ_HANDLERS && chainNodes[i].handler != 0; i++);
+
+        if (i == MAX_IRQ_HANDLERS)
+        {
+            return REGISTRY_FULL;
+        }
+
+        node = &chainNodes[i];
+        node->handler = handler;
+    }
+    else if (keepHigher && node->priority < priority)
+    {
+        priority = node->priority;
+    }
+
+    node->priority = priority;
+    Link(node, IRQn);
+    InstallChain(IRQn);
+
+    return NO_ERROR;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Copies the vector table to SRAM and points VTOR at the copy
+ */
+void G8RTOS_InitDispatch()
+{
+    bootVectors = (const uint32_t *)SCB->VTOR;
+    memcpy(ramVectors, bootVectors, sizeof(ramVectors));
+    memset(chainNodes, 0, sizeof(chainNodes));
+    memset(chainOfIRQ, 0, sizeof(chainOfIRQ));
+    memset(pinHandlers, 0, sizeof(pinHandlers));
+
+    SCB->VTOR = (uint32_t)ramVectors;
+    asm("   DSB ");
+}
+
+/*
+ * Adds a handler to the chain of a peripheral interrupt and enables it
+ */
+sched_ErrCode_t G8RTOS_AddIrqHandler(void (*handler)(void), uint8_t priority, IRQn_Type IRQn)
+{
+    if (IRQn < PSS_IRQn || IRQn >= NUMBER_OF_IRQS || handler == 0)
+    {
+        return IRQn_INVALID;
+    }
+
+    if (priority > MAX_IRQ_PRIORITY)
+    {
+        return HWI_PRIORITY_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    sched_ErrCode_t error = AddToChain(handler, priority, IRQn, false);
+
+    EndCriticalSection(IBit_State);
+
+    return error;
+}
+
+/*
+ * Removes a handler from the chain of a peripheral interrupt
+ */
+sched_ErrCode_t G8RTOS_RemoveIrqHandler(void (*handler)(void), IRQn_Type IRQn)
+{
+    if (IRQn < PSS_IRQn || IRQn >= NUMBER_OF_IRQS)
+    {
+        return IRQn_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    irq_chain_node_t *node = Unlink(handler, IRQn);
+
+    if (node == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return EVENT_DOES_NOT_EXIST;
+    }
+
+    node->handler = 0;
+    node->next = 0;
+    InstallChain(IRQn);
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Sets the handler of one GPIO pin and enables its interrupt
+ */
+sched_ErrCode_t G8RTOS_AddPinHandler(void (*handler)(void), uint8_t priority, uint8_t port, uint8_t pin, bool fallingEdge)
+{
+    if (port < 1 || port > NUMBER_OF_GPIO_PORTS || pin >= PINS_PER_PORT || handler == 0)
+    {
+        return PIN_INVALID;
+    }
+
+    if (priority > MAX_IRQ_PRIORITY)
+    {
+        return HWI_PRIORITY_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    /* the port keeps the most urgent priority of its pins */
+    sched_ErrCode_t error = AddToChain(PortDispatcher, priority, (IRQn_Type)(PORT1_IRQn + port - 1), true);
+
+    if (error == NO_ERROR)
+    {
+        pinHandlers[port-1][pin] = handler;
+
+        GPIO_interruptEdgeSelect(port, 1 << pin, fallingEdge ? GPIO_HIGH_TO_LOW_TRANSITION : GPIO_LOW_TO_HIGH_TRANSITION);
+        GPIO_clearInterruptFlag(port, 1 << pin);
+        GPIO_enableInterrupt(port, 1 << pin);
+    }
+
+    EndCriticalSection(IBit_State);
+
+    return error;
+}
+
+/*
+ * Disables the interrupt of one GPIO pin and removes its handler
+ */
+sched_ErrCode_t G8RTOS_RemovePinHandler(uint8_t port, uint8_t pin)
+{
+    if (port < 1 || port > NUMBER_OF_GPIO_PORTS || pin >= PINS_PER_PORT)
+    {
+        return PIN_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if (pinHandlers[port-1][pin] == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return EVENT_DOES_NOT_EXIST;
+    }
+
+    GPIO_disableInterrupt(port, 1 << pin);
+    GPIO_clearInterruptFlag(port, 1 << pin);
+    pinHandlers[port-1][pin] = 0;
+
+    /* the port dispatcher leaves the chain with the last pin */
+    uint32_t i = 0;
+    for (i = 0; i < PINS_PER_PORT && pinHandlers[port-1][i] == 0; i++);
+
+    if (i == PINS_PER_PORT)
+    {
+        IRQn_Type IRQn = (IRQn_Type)(PORT1_IRQn + port - 1);
+        irq_chain_node_t *node = Unlink(PortDispatcher, IRQn);
+
+        node->handler = 0;
+        node->next = 0;
+        InstallChain(IRQn);
+    }
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*********************************************** Public Functions *********************************************************************/
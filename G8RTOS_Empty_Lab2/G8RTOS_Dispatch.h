@@ -0,0 +1,88 @@
+/*
+ * G8RTOS_Dispatch.h
+ *
+ * Interrupt dispatch layer
+ *  - G8RTOS_Init copies the vector table into the .vtable section at the start of SRAM
+ *  - Every peripheral interrupt has a chain of handlers sorted by priority, so drivers can share one interrupt.
+ *    A chain of one handler sits directly in the vector table, longer chains go through a dispatcher
+ *  - GPIO ports dispatch per pin: the port dispatcher reads PxIV, which names the highest pending pin
+ *    and clears its flag, and calls that pin's handler from a table. Pin 0 is served first
+ *  - On a port with pin handlers every pin must use a pin handler, a whole-port handler in the same chain
+ *    would find the flags already cleared
+ */
+
+#ifndef G8RTOS_DISPATCH_H_
+#define G8RTOS_DISPATCH_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Handlers in all chains together */
+#define MAX_IRQ_HANDLERS 16
+
+/* Lowest interrupt priority a handler can ask for, 7 belongs to PendSV and SysTick */
+#define MAX_IRQ_PRIORITY 6
+
+/* GPIO ports with interrupts, P1 to P6 */
+#define NUMBER_OF_GPIO_PORTS 6
+#define PINS_PER_PORT 8
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Copies the vector table to SRAM and points VTOR at the copy
+ *  - Called by G8RTOS_Init
+ */
+void G8RTOS_InitDispatch();
+
+/*
+ * Adds a handler to the chain of a peripheral interrupt and enables it
+ *  - Handlers with a lower priority number are called first, the interrupt runs at the lowest number in its chain
+ *  - Adding a handler that is already in the chain only updates its priority
+ * Param "handler": Interrupt handler, must clear its own flags
+ * Param "priority": Interrupt priority, 0 to MAX_IRQ_PRIORITY
+ * Param "IRQn": Peripheral interrupt
+ * Returns: IRQn_INVALID, HWI_PRIORITY_INVALID, or REGISTRY_FULL if MAX_IRQ_HANDLERS are in use
+ */
+sched_ErrCode_t G8RTOS_AddIrqHandler(void (*handler)(void), uint8_t priority, IRQn_Type IRQn);
+
+/*
+ * Removes a handler from the chain of a peripheral interrupt
+ *  - The interrupt is disabled and gets its startup handler back when the chain is empty
+ * Param "handler": Handler to remove
+ * Param "IRQn": Peripheral interrupt
+ * Returns: IRQn_INVALID, or EVENT_DOES_NOT_EXIST if the handler is not in the chain
+ */
+sched_ErrCode_t G8RTOS_RemoveIrqHandler(void (*handler)(void), IRQn_Type IRQn);
+
+/*
+ * Sets the handler of one GPIO pin and enables its interrupt
+ *  - The pin must already be an input, its flag is cleared before the interrupt is enabled
+ *  - The port interrupt runs at the lowest priority number of its pins
+ *  - The handler is called after the flag was cleared by reading PxIV
+ * Param "handler": Pin handler
+ * Param "priority": Interrupt priority, 0 to MAX_IRQ_PRIORITY
+ * Param "port": 1 to NUMBER_OF_GPIO_PORTS
+ * Param "pin": 0 to 7
+ * Param "fallingEdge": true for a high to low transition, false for low to high
+ * Returns: PIN_INVALID, HWI_PRIORITY_INVALID, or REGISTRY_FULL if the port dispatcher can not be added
+ */
+sched_ErrCode_t G8RTOS_AddPinHandler(void (*handler)(void), uint8_t priority, uint8_t port, uint8_t pin, bool fallingEdge);
+
+/*
+ * Disables the interrupt of one GPIO pin and removes its handler
+ * Param "port": 1 to NUMBER_OF_GPIO_PORTS
+ * Param "pin": 0 to 7
+ * Returns: PIN_INVALID, or EVENT_DOES_NOT_EXIST if the pin has no handler
+ */
+sched_ErrCode_t G8RTOS_RemovePinHandler(uint8_t port, uint8_t pin);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_DISPATCH_H_ */
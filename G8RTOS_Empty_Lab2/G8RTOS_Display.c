@@ -0,0 +1,557 @@
+/*
+ * G8RTOS_Display.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_Display.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_Dispatch.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+typedef enum {
+    DISPLAY_FILL = 0,
+    DISPLAY_TEXT,
+    DISPLAY_TEXT_BURST,
+    DISPLAY_BITMAP,
+    DISPLAY_SPRITE,
+    DISPLAY_LINE,
+    DISPLAY_CIRCLE,
+    DISPLAY_FENCE,
+    DISPLAY_FRAME
+} display_cmd_type_t;
+
+/*
+ * Draw command
+ *  - Rectangles use xStart/xEnd/yStart/yEnd with exclusive ends, lines (x0, y0) to (x1, y1) in the same fields,
+ *    text and sprites their position in xStart/yStart and opaque text its background in xEnd, circles their center in xStart/yStart and the radius in xEnd
+ */
+typedef struct display_cmd_t {
+    uint8_t type;
+    uint16_t color;
+    int16_t xStart;
+    int16_t xEnd;
+    int16_t yStart;
+    int16_t yEnd;
+    union {
+        const uint16_t *pixels;
+        const LCD_Sprite *sprite;
+        semaphore_t *fence;
+        char text[DISPLAY_TEXT_LENGTH];
+    } data;
+} display_cmd_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Signalled by the LCD DMA interrupt at the end of every stream */
+static semaphore_t LCDDMADone;
+
+/*
+ * Render queue
+ *  - Producers reserve tail with interrupts masked and publish the slot once it is filled
+ *  - Only the render thread moves head, a slot is drawn once it is published
+ *  - Commands publish and signal in one critical section, so a published slot has always been counted
+ */
+static display_cmd_t queue[DISPLAY_QUEUE_LENGTH];
+static volatile bool published[DISPLAY_QUEUE_LENGTH];
+static volatile uint32_t queueHead = 0;
+static volatile uint32_t queueTail = 0;
+static semaphore_t commandsPending;
+
+static display_stats_t stats;
+
+/*
+ * Frame pacer
+ *  - The FMARK handler counts pulses and wakes the render thread once frameCount reaches frameTarget
+ */
+static bool framePaced = false;
+static uint8_t frameDivider = 1;
+static semaphore_t frameMarker;
+static volatile uint32_t frameCount = 0;
+static volatile uint32_t frameTarget = 0;
+static volatile bool frameWaiting = false;
+static bool frameStarted = false;
+static uint32_t rateWindowStart = 0;
+static uint32_t rateWindowFrames = 0;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Blocks the drawing thread until its stream is done
+ */
+static void WaitLCDDMA()
+{
+    G8RTOS_WaitSemaphore(&LCDDMADone);
+}
+
+/*
+ * Called from the DMA interrupt
+ */
+static void SignalLCDDMA()
+{
+    G8RTOS_SignalSemaphore(&LCDDMADone);
+}
+
+/*
+ * FMARK pin handler
+ */
+static void FrameMarkerHandler()
+{
+    frameCount++;
+
+    if (G8RTOS_TimeAfterEq(SystemTime, rateWindowStart + 1000))
+    {
+        stats.frameRate = frameCount - rateWindowFrames;
+        rateWindowFrames = frameCount;
+        rateWindowStart = SystemTime;
+    }
+
+    if (frameWaiting && (int32_t)(frameCount - frameTarget) >= 0)
+    {
+        frameWaiting = false;
+        G8RTOS_SignalSemaphore(&frameMarker);
+    }
+}
+
+/*
+ * Holds the render thread until the frame the next commands belong to starts
+ */
+static void WaitFrame()
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (!frameStarted)
+    {
+        frameTarget = frameCount + 1;
+        frameStarted = true;
+    }
+    else if ((int32_t)(frameCount - frameTarget) >= 0)
+    {
+        /* still drawing the previous frame when this one was due, start with the next pulse */
+        stats.missedFrames += frameCount - frameTarget + 1;
+        frameTarget = frameCount + 1;
+    }
+
+    frameWaiting = true;
+
+    EndCriticalSection(IBit_State);
+
+    G8RTOS_WaitSemaphore(&frameMarker);
+
+    frameTarget += frameDivider;
+}
+
+/*
+ * Reserves the next slot of the queue
+ * Returns: the slot, 0 if the queue is full
+ */
+static display_cmd_t *Reserve(uint8_t type)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (queueTail - queueHead >= DISPLAY_QUEUE_LENGTH)
+    {
+        stats.dropped++;
+        EndCriticalSection(IBit_State);
+        return 0;
+    }
+
+    display_cmd_t *cmd = &queue[queueTail % DISPLAY_QUEUE_LENGTH];
+    queueTail++;
+    stats.queued++;
+
+    EndCriticalSection(IBit_State);
+
+    cmd->type = type;
+    return cmd;
+}
+
+/*
+ * Hands a filled slot to the render thread
+ */
+static void Publish(display_cmd_t *cmd)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    published[cmd - queue] = true;
+    G8RTOS_SignalSemaphore(&commandsPending);
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Queues a command with a rectangle
+ */
+static sched_ErrCode_t QueueRect(uint8_t type, int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t color)
+{
+    display_cmd_t *cmd = Reserve(type);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    cmd->xStart = xStart;
+    cmd->xEnd = xEnd;
+    cmd->yStart = yStart;
+    cmd->yEnd = yEnd;
+    cmd->color = color;
+
+    Publish(cmd);
+
+    return NO_ERROR;
+}
+
+/*
+ * Reserves, fills and publishes a text command
+ */
+static sched_ErrCode_t QueueText(uint8_t type, int16_t x, int16_t y, const char *text, uint16_t color, uint16_t background)
+{
+    display_cmd_t *cmd = Reserve(type);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    cmd->xStart = x;
+    cmd->xEnd = background;
+    cmd->yStart = y;
+    cmd->color = color;
+    strncpy(cmd->data.text, text, DISPLAY_TEXT_LENGTH - 1);
+    cmd->data.text[DISPLAY_TEXT_LENGTH - 1] = 0;
+
+    Publish(cmd);
+
+    return NO_ERROR;
+}
+
+/*
+ * Merges the next fill into a fill if both share a window
+ * Returns: true if the next command was merged and taken off the queue
+ */
+static bool Coalesce(display_cmd_t *cmd)
+{
+    uint32_t index = (queueHead % DISPLAY_QUEUE_LENGTH);
+    display_cmd_t *next = &queue[index];
+
+    if (queueHead == queueTail || !published[index] || next->type != DISPLAY_FILL)
+    {
+        return false;
+    }
+
+    bool sameX = (next->xStart == cmd->xStart && next->xEnd == cmd->xEnd);
+    bool sameY = (next->yStart == cmd->yStart && next->yEnd == cmd->yEnd);
+
+    if (sameX && sameY)
+    {
+        /* the same window is drawn over, only the later color shows */
+        cmd->color = next->color;
+    }
+    else if (next->color == cmd->color && sameX && (next->yStart == cmd->yEnd || next->yEnd == cmd->yStart))
+    {
+        cmd->yStart = (next->yStart < cmd->yStart) ? next->yStart : cmd->yStart;
+        cmd->yEnd = (next->yEnd > cmd->yEnd) ? next->yEnd : cmd->yEnd;
+    }
+    else if (next->color == cmd->color && sameY && (next->xStart == cmd->xEnd || next->xEnd == cmd->xStart))
+    {
+        cmd->xStart = (next->xStart < cmd->xStart) ? next->xStart : cmd->xStart;
+        cmd->xEnd = (next->xEnd > cmd->xEnd) ? next->xEnd : cmd->xEnd;
+    }
+    else
+    {
+        return false;
+    }
+
+    /* published slots have been counted, so this never fails */
+    G8RTOS_TryWaitSemaphore(&commandsPending);
+    published[index] = false;
+    queueHead++;
+    stats.coalesced++;
+
+    return true;
+}
+
+/*
+ * Draws one command
+ */
+static void Draw(display_cmd_t *cmd)
+{
+    switch (cmd->type)
+    {
+    case DISPLAY_FILL:
+        LCD_DrawRectangle(cmd->xStart, cmd->xEnd, cmd->yStart, cmd->yEnd, cmd->color);
+        break;
+    case DISPLAY_TEXT:
+        LCD_Text(cmd->xStart, cmd->yStart, (uint8_t *)cmd->data.text, cmd->color);
+        break;
+    case DISPLAY_TEXT_BURST:
+        LCD_TextBurst(cmd->xStart, cmd->yStart, (const uint8_t *)cmd->data.text, cmd->color, (uint16_t)cmd->xEnd);
+        break;
+    case DISPLAY_BITMAP:
+        LCD_DrawBitmap(cmd->xStart, cmd->xEnd, cmd->yStart, cmd->yEnd, cmd->data.pixels);
+        break;
+    case DISPLAY_SPRITE:
+        LCD_DrawSprite(cmd->data.sprite, cmd->xStart, cmd->yStart);
+        break;
+    case DISPLAY_LINE:
+        LCD_DrawLine(cmd->xStart, cmd->yStart, cmd->xEnd, cmd->yEnd, cmd->color);
+        break;
+    case DISPLAY_CIRCLE:
+        LCD_FillCircle(cmd->xStart, cmd->yStart, cmd->xEnd, cmd->color);
+        break;
+    case DISPLAY_FENCE:
+        G8RTOS_SignalSemaphore(cmd->data.fence);
+        return;
+    case DISPLAY_FRAME:
+        if (framePaced)
+        {
+            WaitFrame();
+        }
+        return;
+    }
+
+    stats.drawn++;
+}
+
+/*
+ * Render thread, the only thread that draws once it runs
+ *  - A slot reserved before the one just published may still be filled by a preempted producer,
+ *    the commands are drawn in the order they were reserved so the thread waits for it
+ */
+static void DisplayThread()
+{
+    display_cmd_t cmd;
+
+    while(1)
+    {
+        G8RTOS_WaitSemaphore(&commandsPending);
+
+        uint32_t index = queueHead % DISPLAY_QUEUE_LENGTH;
+        while (!published[index])
+        {
+            sleep(1);
+        }
+
+        cmd = queue[index];
+        published[index] = false;
+        queueHead++;
+
+        if (cmd.type == DISPLAY_FILL)
+        {
+            while (Coalesce(&cmd));
+        }
+
+        Draw(&cmd);
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Installs the LCD DMA hooks
+ */
+void G8RTOS_InitDisplay()
+{
+    G8RTOS_InitSemaphore(&LCDDMADone, 0);
+    LCD_SetDMAHooks(WaitLCDDMA, SignalLCDDMA);
+}
+
+/*
+ * Installs the LCD DMA hooks and adds the render thread
+ */
+sched_ErrCode_t G8RTOS_StartDisplay(uint8_t priority)
+{
+    G8RTOS_InitDisplay();
+    G8RTOS_InitSemaphore(&commandsPending, 0);
+    queueHead = 0;
+    queueTail = 0;
+    memset((void *)published, 0, sizeof(published));
+    memset(&stats, 0, sizeof(stats));
+    framePaced = false;
+
+    return G8RTOS_AddThread(DisplayThread, priority, "display");
+}
+
+/*
+ * Queues a filled rectangle
+ */
+sched_ErrCode_t G8RTOS_DisplayFillRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t color)
+{
+    return QueueRect(DISPLAY_FILL, xStart, xEnd, yStart, yEnd, color);
+}
+
+/*
+ * Queues a string
+ */
+sched_ErrCode_t G8RTOS_DisplayText(int16_t x, int16_t y, const char *text, uint16_t color)
+{
+    return QueueText(DISPLAY_TEXT, x, y, text, color, 0);
+}
+
+/*
+ * Queues a string drawn over its background in one burst
+ */
+sched_ErrCode_t G8RTOS_DisplayTextBurst(int16_t x, int16_t y, const char *text, uint16_t color, uint16_t background)
+{
+    return QueueText(DISPLAY_TEXT_BURST, x, y, text, color, background);
+}
+
+/*
+ * Queues a bitmap
+ */
+sched_ErrCode_t G8RTOS_DisplayBitmap(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels)
+{
+    display_cmd_t *cmd = Reserve(DISPLAY_BITMAP);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    cmd->xStart = xStart;
+    cmd->xEnd = xEnd;
+    cmd->yStart = yStart;
+    cmd->yEnd = yEnd;
+    cmd->data.pixels = pixels;
+
+    Publish(cmd);
+
+    return NO_ERROR;
+}
+
+/*
+ * Queues a sprite
+ */
+sched_ErrCode_t G8RTOS_DisplaySprite(const LCD_Sprite *sprite, int16_t x, int16_t y)
+{
+    display_cmd_t *cmd = Reserve(DISPLAY_SPRITE);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    cmd->xStart = x;
+    cmd->yStart = y;
+    cmd->data.sprite = sprite;
+
+    Publish(cmd);
+
+    return NO_ERROR;
+}
+
+/*
+ * Queues a line
+ */
+sched_ErrCode_t G8RTOS_DisplayLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+    return QueueRect(DISPLAY_LINE, x0, x1, y0, y1, color);
+}
+
+/*
+ * Queues a filled circle
+ */
+sched_ErrCode_t G8RTOS_DisplayFillCircle(int16_t x, int16_t y, int16_t radius, uint16_t color)
+{
+    return QueueRect(DISPLAY_CIRCLE, x, radius, y, 0, color);
+}
+
+/*
+ * Paces the render thread with the panel's FMARK pulse
+ */
+sched_ErrCode_t G8RTOS_StartFramePacer(uint8_t port, uint8_t pin, uint8_t priority, uint8_t divider)
+{
+    G8RTOS_InitSemaphore(&frameMarker, 0);
+    frameDivider = (divider == 0) ? 1 : divider;
+    frameCount = 0;
+    frameWaiting = false;
+    frameStarted = false;
+    rateWindowStart = SystemTime;
+    rateWindowFrames = 0;
+
+    sched_ErrCode_t error = G8RTOS_AddPinHandler(FrameMarkerHandler, priority, port, pin, false);
+
+    if (error == NO_ERROR)
+    {
+        LCD_SetFrameMarker(true);
+        framePaced = true;
+    }
+
+    return error;
+}
+
+/*
+ * Queues a frame boundary
+ */
+sched_ErrCode_t G8RTOS_DisplayNextFrame()
+{
+    display_cmd_t *cmd = Reserve(DISPLAY_FRAME);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    Publish(cmd);
+
+    return NO_ERROR;
+}
+
+/*
+ * Waits until every command queued before has been drawn
+ */
+sched_ErrCode_t G8RTOS_DisplayFlush()
+{
+    semaphore_t done;
+    display_cmd_t *cmd = Reserve(DISPLAY_FENCE);
+
+    if (cmd == 0)
+    {
+        return QUEUE_FULL;
+    }
+
+    G8RTOS_InitSemaphore(&done, 0);
+    cmd->data.fence = &done;
+
+    Publish(cmd);
+
+    G8RTOS_WaitSemaphore(&done);
+
+    return NO_ERROR;
+}
+
+/*
+ * Copies the render queue statistics
+ */
+void G8RTOS_GetDisplayStats(display_stats_t *s)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    *s = stats;
+    s->frames = frameCount;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,150 @@
+/*
+ * G8RTOS_Display.h
+ *
+ * LCD access from threads
+ *  - LCDLib streams pixels by DMA, G8RTOS_InitDisplay makes the drawing thread sleep on a semaphore during
+ *    the transfer instead of spinning, so other threads run while the SPI is busy
+ *  - G8RTOS_StartDisplay adds a render thread that owns the LCD. Threads queue draw commands and return at once,
+ *    the render thread draws them in order, so no thread waits for the SPI or for another thread's drawing
+ *  - Queueing never blocks: a slot is reserved in a few instructions with interrupts masked, filled with interrupts
+ *    enabled, then published. Commands that find the queue full are dropped and counted
+ *  - Fills that share a window with the fill queued right after them are coalesced: an identical window is only drawn
+ *    once with the later color, fills of one color that line up into one rectangle are drawn as one
+ *  - With G8RTOS_StartFramePacer the panel's FMARK pulse paces drawing: G8RTOS_DisplayNextFrame queues a frame boundary,
+ *    the render thread holds the commands after it until the next pulse, so a frame's drawing starts right behind the scan.
+ *    A frame whose drawing is still running when its successor is due misses that pulse and is counted
+ */
+
+#ifndef G8RTOS_DISPLAY_H_
+#define G8RTOS_DISPLAY_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Semaphores.h"
+#include "LCDSprite.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Commands waiting to be drawn */
+#define DISPLAY_QUEUE_LENGTH 32
+
+/* Characters of a text command, including the terminating 0, longer strings are cut */
+#define DISPLAY_TEXT_LENGTH 16
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Render queue statistics
+ */
+typedef struct display_stats_t {
+    uint32_t queued;
+    uint32_t drawn;         // commands drawn after coalescing
+    uint32_t coalesced;     // commands merged into the one before them
+    uint32_t dropped;       // commands that found the queue full
+    uint32_t frames;        // FMARK pulses
+    uint32_t frameRate;     // FMARK pulses in the last full second
+    uint32_t missedFrames;  // pulses a frame boundary was late for
+} display_stats_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Installs the LCD DMA hooks
+ *  - Call after LCD_Init and before G8RTOS_Launch, LCD_Init itself still spins
+ *  - Afterwards the LCD may only be drawn from threads
+ */
+void G8RTOS_InitDisplay();
+
+/*
+ * Installs the LCD DMA hooks and adds the render thread
+ *  - Call after LCD_Init and before G8RTOS_Launch
+ *  - Afterwards only the render thread may draw, other threads use the G8RTOS_Display functions
+ * Param "priority": Priority of the render thread
+ * Returns: Error code for adding the thread
+ */
+sched_ErrCode_t G8RTOS_StartDisplay(uint8_t priority);
+
+/*
+ * Queues a filled rectangle, same coordinates as LCD_DrawRectangle
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayFillRect(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, uint16_t color);
+
+/*
+ * Queues a string, drawn with LCD_Text
+ * Param "text": Copied into the command, at most DISPLAY_TEXT_LENGTH - 1 characters are drawn
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayText(int16_t x, int16_t y, const char *text, uint16_t color);
+
+/*
+ * Queues a string drawn with LCD_TextBurst: one window and one burst, the background is painted as well
+ *  - For scores and HUD text that is redrawn in place, the old text needs no clearing first
+ * Param "text": Copied into the command, at most DISPLAY_TEXT_LENGTH - 1 characters are drawn
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayTextBurst(int16_t x, int16_t y, const char *text, uint16_t color, uint16_t background);
+
+/*
+ * Queues a bitmap, same arguments as LCD_DrawBitmap
+ *  - The pixels are not copied, they must stay unchanged until G8RTOS_DisplayFlush returns or for good
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayBitmap(int16_t xStart, int16_t xEnd, int16_t yStart, int16_t yEnd, const uint16_t *pixels);
+
+/*
+ * Queues a sprite, same arguments as LCD_DrawSprite
+ *  - The sprite is not copied, it must stay unchanged until G8RTOS_DisplayFlush returns or for good
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplaySprite(const LCD_Sprite *sprite, int16_t x, int16_t y);
+
+/*
+ * Queues a one pixel wide line from (x0, y0) to (x1, y1), both ends included
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/*
+ * Queues a filled circle, same arguments as LCD_FillCircle
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayFillCircle(int16_t x, int16_t y, int16_t radius, uint16_t color);
+
+/*
+ * Paces the render thread with the panel's FMARK pulse
+ *  - Call after G8RTOS_StartDisplay and before G8RTOS_Launch
+ * Param "port", "pin": GPIO the LCD FMARK line is wired to
+ * Param "priority": Priority of the pin interrupt
+ * Param "divider": Frames per drawn frame, 1 draws at the panel's refresh rate, 2 at half of it
+ * Returns: Error code for adding the pin handler
+ */
+sched_ErrCode_t G8RTOS_StartFramePacer(uint8_t port, uint8_t pin, uint8_t priority, uint8_t divider);
+
+/*
+ * Queues a frame boundary, commands queued after it are drawn from the next FMARK pulse on
+ *  - Without G8RTOS_StartFramePacer it does nothing
+ * Returns: QUEUE_FULL if the command was dropped
+ */
+sched_ErrCode_t G8RTOS_DisplayNextFrame();
+
+/*
+ * Waits until every command the calling thread queued before has been drawn
+ * Returns: QUEUE_FULL if no fence could be queued, nothing was waited for
+ */
+sched_ErrCode_t G8RTOS_DisplayFlush();
+
+/*
+ * Copies the render queue statistics
+ */
+void G8RTOS_GetDisplayStats(display_stats_t *stats);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_DISPLAY_H_ */
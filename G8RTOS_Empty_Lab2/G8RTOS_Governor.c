@@ -0,0 +1,177 @@
+/*
+ * G8RTOS_Governor.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "BSP.h"
+#include "i2c_driver.h"
+#include "G8RTOS_Governor.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Range of levels the governor may choose from */
+static ClockSysLevel_t governorMinLevel = ClockSys_Level12MHz;
+static ClockSysLevel_t governorMaxLevel = ClockSys_Level48MHz;
+
+/* Busy percentage of the last window */
+static uint32_t governorLoad = 100;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Returns whether a peripheral clocked from SMCLK is in the middle of a transfer
+ *  - The CC3100 SPI runs at SMCLK/1 and is only slowed down by a lower level, it is not checked
+ *  - An LCD DMA stream keeps running while the thread that started it sleeps, the SPI is idle between its bytes
+ */
+static inline bool PeripheralsBusy()
+{
+    return ((UCA0STATW & UCBUSY) || (UCB3STATW & UCBUSY) || LCD_DMABusy() || (UCB1STATW & UCBBUSY));
+}
+
+/*
+ * Picks the level for the next window
+ */
+static ClockSysLevel_t NextLevel(ClockSysLevel_t level, uint32_t load)
+{
+    if (level < governorMinLevel)
+    {
+        return governorMinLevel;
+    }
+
+    if (level > governorMaxLevel)
+    {
+        return governorMaxLevel;
+    }
+
+    if (load > GOVERNOR_UP_LOAD && level < governorMaxLevel)
+    {
+        return (ClockSysLevel_t)(level + 1);
+    }
+
+    if (load < GOVERNOR_DOWN_LOAD && level > governorMinLevel)
+    {
+        return (ClockSysLevel_t)(level - 1);
+    }
+
+    return level;
+}
+
+/*
+ * Governor thread
+ *  - Measures the busy percentage of every window and steps the clock by at most one level
+ *  - The window restarts after a switch so no window mixes two clock speeds
+ */
+static void GovernorThread()
+{
+    uint32_t lastWake = SystemTime;
+    uint32_t startIdle = 0;
+    uint32_t startTotal = 0;
+    uint32_t idle = 0;
+    uint32_t total = 0;
+
+    G8RTOS_GetIdleCycles(&startIdle, &startTotal);
+
+    while(1)
+    {
+        sleepUntil(&lastWake, GOVERNOR_WINDOW);
+
+        G8RTOS_GetIdleCycles(&idle, &total);
+        idle -= startIdle;
+        total -= startTotal;
+
+        if (total != 0)
+        {
+            governorLoad = 100 - (uint32_t)(((uint64_t)idle * 100) / total);
+        }
+
+        ClockSysLevel_t level = ClockSys_GetLevel();
+        ClockSysLevel_t next = NextLevel(level, governorLoad);
+
+        if (next != level)
+        {
+            G8RTOS_SetClockLevel(next);
+        }
+
+        G8RTOS_GetIdleCycles(&startIdle, &startTotal);
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the governor thread to the scheduler
+ */
+sched_ErrCode_t G8RTOS_StartGovernor(uint8_t priority)
+{
+    return G8RTOS_AddThread(GovernorThread, priority, "governor");
+}
+
+/*
+ * Limits the clock levels the governor may choose from
+ */
+void G8RTOS_GovernorSetRange(ClockSysLevel_t minLevel, ClockSysLevel_t maxLevel)
+{
+    if (minLevel > maxLevel || maxLevel >= ClockSys_NumLevels)
+    {
+        return;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    governorMinLevel = minLevel;
+    governorMaxLevel = maxLevel;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Returns the busy percentage measured in the last window
+ */
+uint32_t G8RTOS_GovernorGetLoad()
+{
+    return governorLoad;
+}
+
+/*
+ * Switches the clocks to a level and reconfigures everything derived from them
+ *  - I2C transfers are interrupt driven, so the wait for idle peripherals happens with interrupts enabled
+ *    and the check is repeated once they are masked
+ */
+void G8RTOS_SetClockLevel(ClockSysLevel_t level)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    while (PeripheralsBusy())
+    {
+        EndCriticalSection(IBit_State);
+        while (PeripheralsBusy());
+        IBit_State = StartCriticalSection();
+    }
+
+    ClockSys_SetLevel(level);
+
+    uint32_t smclkFreq = ClockSys_GetSMCLKFreq();
+
+    G8RTOS_UpdateSysTick();
+    BackChannelUpdateClock(smclkFreq);
+    LCD_UpdateSPIClock(smclkFreq);
+    updateI2CClock(smclkFreq);
+
+    EndCriticalSection(IBit_State);
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,68 @@
+/*
+ * G8RTOS_Governor.h
+ *
+ * Dynamic clock scaling
+ *  - The governor thread measures the fraction of CPU cycles spent in IDLE_PRIORITY threads every GOVERNOR_WINDOW ms
+ *  - A busy CPU steps MCLK/HSMCLK/SMCLK and the core voltage up one level, a mostly idle one steps them down
+ *  - Every switch reloads SysTick and recomputes the back channel UART baud, the LCD SPI divider and the I2C clock
+ *  - Without a thread at IDLE_PRIORITY the CPU always looks busy and the governor stays at the top of its range
+ */
+
+#ifndef G8RTOS_GOVERNOR_H_
+#define G8RTOS_GOVERNOR_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "ClockSys.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Length of a measurement window in ms */
+#define GOVERNOR_WINDOW 100
+
+/* Busy percentage above which the clock steps up */
+#define GOVERNOR_UP_LOAD 80
+
+/*
+ * Busy percentage below which the clock steps down
+ *  - Halving the clock roughly doubles the load, so this has to stay below half of GOVERNOR_UP_LOAD
+ */
+#define GOVERNOR_DOWN_LOAD 35
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds the governor thread to the scheduler
+ * Param "priority": Priority of the governor thread, it only runs once per window
+ * Returns: Error code for adding the thread
+ */
+sched_ErrCode_t G8RTOS_StartGovernor(uint8_t priority);
+
+/*
+ * Limits the clock levels the governor may choose from
+ *  - e.g. pin ClockSys_Level48MHz during gameplay, allow the full range in menus
+ *  - The current level is moved into the range at the end of the current window
+ * Param "minLevel": Slowest level allowed
+ * Param "maxLevel": Fastest level allowed
+ */
+void G8RTOS_GovernorSetRange(ClockSysLevel_t minLevel, ClockSysLevel_t maxLevel);
+
+/*
+ * Returns the busy percentage measured in the last window
+ */
+uint32_t G8RTOS_GovernorGetLoad();
+
+/*
+ * Switches the clocks to a level and reconfigures everything derived from them
+ *  - Waits until the back channel UART, the LCD SPI and the I2C bus are idle
+ *  - Can be used without the governor thread
+ * Param "level": Clock level to switch to
+ */
+void G8RTOS_SetClockLevel(ClockSysLevel_t level);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_GOVERNOR_H_ */
@@ -5,9 +5,12 @@
  *      Author: Daniel Gonzalez
  */
 #include <stdint.h>
+#include <string.h>
 #include "msp.h"
 #include "G8RTOS_IPC.h"
 #include "G8RTOS_Semaphores.h"
+#include "G8RTOS_Static.h"
+#include "G8RTOS_CriticalSection.h"
 
 /*********************************************** Defines ******************************************************************************/
 
@@ -39,8 +42,29 @@ typedef struct FIFO_t {
     semaphore_t Mutex;
 } FIFO_t;
 
+#ifdef G8RTOS_STATIC_CONFIG
+
+G8RTOS_STATIC_ASSERT(G8RTOS_STATIC_FIFO_COUNT <= MAX_NUMBER_OF_FIFOS, too_many_static_fifos);
+
+/* Static FIFOs start empty, the same state G8RTOS_InitFIFO leaves them in */
+#define G8RTOS_STATIC_FIFO(index) \
+    [index] = { \
+        .head = &FIFOs[index].Buffer[0], \
+        .tail = &FIFOs[index].Buffer[0], \
+        .lostData = 0, \
+        .CurrentSize = 0, \
+        .Mutex = 1 \
+    },
+
+/* Array of FIFOS, the leading empty entry keeps the initializer valid when no FIFO is listed */
+static FIFO_t FIFOs[MAX_NUMBER_OF_FIFOS] = { { { 0 } }, G8RTOS_STATIC_FIFOS(G8RTOS_STATIC_FIFO) };
+
+#else
+
 /* Array of FIFOS */
-static FIFO_t FIFOs[4];
+static FIFO_t FIFOs[MAX_NUMBER_OF_FIFOS];
+
+#endif /* G8RTOS_STATIC_CONFIG */
 
 static void advance_head_pointer(FIFO_t * pt)
 {
@@ -156,3 +180,108 @@ int writeFIFO(uint32_t FIFOChoice, uint32_t Data)
     return err;
 }
 
+/*
+ * Copies the fill level and lost data count of a FIFO
+ *  - A negative size is the number of readers waiting on an empty FIFO
+ */
+int G8RTOS_GetFIFOStats(uint32_t FIFOChoice, int32_t *size, uint32_t *lostData)
+{
+    if (FIFOChoice >= MAX_NUMBER_OF_FIFOS)
+    {
+        return -1;
+    }
+
+    *size = FIFOs[FIFOChoice].CurrentSize;
+    *lostData = FIFOs[FIFOChoice].lostData;
+
+    return 0;
+}
+
+/*
+ * Initializes a seqlock
+ */
+void G8RTOS_InitSeqlock(seqlock_t *lock)
+{
+    lock->sequence = 0;
+    lock->retries = 0;
+}
+
+/*
+ * Starts an in-place update of the data protected by a seqlock
+ *  - The sequence is odd until G8RTOS_SeqlockWriteEnd
+ */
+int32_t G8RTOS_SeqlockWriteBegin(seqlock_t *lock)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    lock->sequence++;
+
+    return IBit_State;
+}
+
+/*
+ * Ends an in-place update and publishes it to readers
+ *  - The sequence is even again and differs from every value a reader could have started with
+ */
+void G8RTOS_SeqlockWriteEnd(seqlock_t *lock, int32_t IBit_State)
+{
+    lock->sequence++;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Starts a read of the data protected by a seqlock
+ */
+uint32_t G8RTOS_SeqlockReadBegin(seqlock_t *lock)
+{
+    return lock->sequence;
+}
+
+/*
+ * Checks whether a read has to be repeated
+ *  - An odd start means the read began inside of a write (only possible for code that
+ *    runs while the writer has interrupts masked, e.g. a fault handler)
+ */
+bool G8RTOS_SeqlockReadRetry(seqlock_t *lock, uint32_t start)
+{
+    if ((start & 1) || (lock->sequence != start))
+    {
+        lock->retries++;
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Replaces the shared data with a new version in one step
+ */
+void G8RTOS_SeqlockPublish(seqlock_t *lock, void *shared, const void *src, uint32_t size)
+{
+    int32_t IBit_State = G8RTOS_SeqlockWriteBegin(lock);
+
+    memcpy(shared, src, size);
+
+    G8RTOS_SeqlockWriteEnd(lock, IBit_State);
+}
+
+/*
+ * Copies a consistent snapshot of the shared data
+ */
+uint32_t G8RTOS_SeqlockSnapshot(seqlock_t *lock, void *dst, const void *shared, uint32_t size)
+{
+    uint32_t retries = 0;
+    uint32_t start = G8RTOS_SeqlockReadBegin(lock);
+
+    memcpy(dst, shared, size);
+
+    while (G8RTOS_SeqlockReadRetry(lock, start))
+    {
+        retries++;
+        start = G8RTOS_SeqlockReadBegin(lock);
+        memcpy(dst, shared, size);
+    }
+
+    return retries;
+}
@@ -8,10 +8,29 @@
 #ifndef G8RTOS_G8RTOS_IPC_H_
 #define G8RTOS_G8RTOS_IPC_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
 /*********************************************** Error Codes **************************************************************************/
 
 /*********************************************** Error Codes **************************************************************************/
 
+/*********************************************** Data Structure Definitions ***********************************************************/
+
+/*
+ * Seqlock
+ *  - Protects shared data that is written by a few threads and read by many
+ *  - Writers never wait: every write happens inside a short critical section and bumps the sequence by 2
+ *  - Readers never take a semaphore: they copy the data and retry if the sequence moved while they copied
+ *  - An odd sequence means a write is in progress
+ */
+typedef struct seqlock_t {
+    volatile uint32_t sequence;
+    uint32_t retries;
+} seqlock_t;
+
+/*********************************************** Data Structure Definitions ***********************************************************/
+
 /*********************************************** Public Functions *********************************************************************/
 
 /*
@@ -38,6 +57,73 @@ uint32_t readFIFO(uint32_t FIFO);
  */
 int writeFIFO(uint32_t FIFO, uint32_t data);
 
+/*
+ * Copies the fill level and lost data count of a FIFO
+ * Param "FIFOChoice": FIFO to query
+ * Param "size": where to store the number of entries waiting to be read
+ * Param "lostData": where to store the number of writes that found the FIFO full
+ * Returns: -1 if the FIFO does not exist
+ */
+int G8RTOS_GetFIFOStats(uint32_t FIFOChoice, int32_t *size, uint32_t *lostData);
+
+/*
+ * Initializes a seqlock
+ * Param "lock": Seqlock to initialize
+ */
+void G8RTOS_InitSeqlock(seqlock_t *lock);
+
+/*
+ * Starts an in-place update of the data protected by a seqlock
+ *  - Masks interrupts until G8RTOS_SeqlockWriteEnd, keep the update short
+ *  - Several writers can update the same data, they are serialized by the critical section
+ * Param "lock": Seqlock protecting the data
+ * Returns: Interrupt state to hand to G8RTOS_SeqlockWriteEnd
+ */
+int32_t G8RTOS_SeqlockWriteBegin(seqlock_t *lock);
+
+/*
+ * Ends an in-place update and publishes it to readers
+ * Param "lock": Seqlock protecting the data
+ * Param "IBit_State": Value returned by G8RTOS_SeqlockWriteBegin
+ */
+void G8RTOS_SeqlockWriteEnd(seqlock_t *lock, int32_t IBit_State);
+
+/*
+ * Starts a read of the data protected by a seqlock
+ * Param "lock": Seqlock protecting the data
+ * Returns: Sequence to hand to G8RTOS_SeqlockReadRetry
+ */
+uint32_t G8RTOS_SeqlockReadBegin(seqlock_t *lock);
+
+/*
+ * Checks whether a read has to be repeated
+ *  - True if a write started or finished since G8RTOS_SeqlockReadBegin
+ * Param "lock": Seqlock protecting the data
+ * Param "start": Sequence returned by G8RTOS_SeqlockReadBegin
+ */
+bool G8RTOS_SeqlockReadRetry(seqlock_t *lock, uint32_t start);
+
+/*
+ * Replaces the shared data with a new version in one step
+ *  - Interrupts are masked for the copy only (a 0x74 byte struct takes about 2 us at 48 MHz)
+ * Param "lock": Seqlock protecting the data
+ * Param "shared": The shared data
+ * Param "src": New version of the data
+ * Param "size": Size of the data in bytes
+ */
+void G8RTOS_SeqlockPublish(seqlock_t *lock, void *shared, const void *src, uint32_t size);
+
+/*
+ * Copies a consistent snapshot of the shared data
+ *  - Never blocks, the copy is repeated if a writer preempted it
+ * Param "lock": Seqlock protecting the data
+ * Param "dst": Where to copy the snapshot
+ * Param "shared": The shared data
+ * Param "size": Size of the data in bytes
+ * Returns: Number of times the copy had to be repeated
+ */
+uint32_t G8RTOS_SeqlockSnapshot(seqlock_t *lock, void *dst, const void *shared, uint32_t size);
+
 /*********************************************** Public Functions *********************************************************************/
 
 
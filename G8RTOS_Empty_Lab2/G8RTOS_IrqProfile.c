@@ -0,0 +1,303 @@
+/*
+ * G8RTOS_IrqProfile.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_IrqProfile.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#ifdef G8RTOS_IRQ_PROFILE
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Profiled vector
+ */
+typedef struct irq_profile_t {
+    void (*handler)(void);
+    uint32_t (*probe)(void);
+    irq_stats_t stats;
+} irq_profile_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Number of entries in the relocated vector table, the first 16 are the core exceptions */
+#define NUMBER_OF_VECTORS 57
+#define FIRST_IRQ_VECTOR 16
+
+#define IRQ_OUTPUT_LENGTH 64
+
+static irq_profile_t profiles[MAX_PROFILED_IRQS];
+static uint32_t numberOfProfiles = 0;
+
+/* Profile of every vector plus one, 0 if it is not profiled */
+static uint8_t profileOfVector[NUMBER_OF_VECTORS];
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Log2 histogram bucket of a value in cycles
+ */
+static uint32_t HistogramBucket(uint32_t value)
+{
+    uint32_t bucket = 0;
+
+    while (value != 0 && bucket < IRQ_HISTOGRAM_BUCKETS - 1)
+    {
+        value >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/*
+ * Cycles since the SysTick counter reloaded, which is when its interrupt was requested
+ */
+static uint32_t SysTickLatency()
+{
+    return SysTick->LOAD - SysTick->VAL;
+}
+
+/*
+ * Finds the profile of a vector
+ * Returns: the profile, or 0 if the vector is not profiled
+ */
+static irq_profile_t *FindProfile(IRQn_Type IRQn)
+{
+    int32_t vector = (int32_t)IRQn + FIRST_IRQ_VECTOR;
+
+    if (vector < 0 || vector >= NUMBER_OF_VECTORS || profileOfVector[vector] == 0)
+    {
+        return 0;
+    }
+
+    return &profiles[profileOfVector[vector] - 1];
+}
+
+/*
+ * Installed in the vector table in place of every profiled handler
+ *  - The active vector number in ICSR tells which handler to call
+ *  - Runs at the priority of the vector, so the same profile is never updated by two nested calls
+ */
+static void IrqProfileWrapper()
+{
+    uint32_t start = DWT->CYCCNT;
+    irq_profile_t *p = &profiles[profileOfVector[SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk] - 1];
+
+    if (p->probe)
+    {
+        uint32_t latency = p->probe();
+
+        p->stats.latencyCount++;
+        p->stats.latency[HistogramBucket(latency)]++;
+        if (latency > p->stats.worstLatency)
+        {
+            p->stats.worstLatency = latency;
+        }
+    }
+
+    p->handler();
+
+    uint32_t duration = DWT->CYCCNT - start;
+
+    p->stats.count++;
+    p->stats.duration[HistogramBucket(duration)]++;
+    if (duration > p->stats.worstDuration)
+    {
+        p->stats.worstDuration = duration;
+    }
+}
+
+/*
+ * Writes the non-empty buckets of a histogram as "lower bound:count"
+ */
+static void DumpHistogram(const char *label, uint32_t *histogram)
+{
+    char output[IRQ_OUTPUT_LENGTH];
+    uint32_t i = 0;
+
+    BackChannelWrite(label);
+
+    for (i = 0; i < IRQ_HISTOGRAM_BUCKETS; i++)
+    {
+        if (histogram[i] != 0)
+        {
+            snprintf(output, IRQ_OUTPUT_LENGTH, " %u:%u",
+                     (unsigned int)((i == 0) ? 0 : (1u << (i - 1))), (unsigned int)histogram[i]);
+            BackChannelWrite(output);
+        }
+    }
+
+    BackChannelWrite("\r\n");
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Wraps the handler in the relocated vector table with the profiling wrapper
+ */
+sched_ErrCode_t G8RTOS_ProfileIRQ(IRQn_Type IRQn)
+{
+    int32_t vector = (int32_t)IRQn + FIRST_IRQ_VECTOR;
+
+    if (IRQn != SysTick_IRQn && (IRQn < PSS_IRQn || vector >= NUMBER_OF_VECTORS))
+    {
+        return IRQn_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if (profileOfVector[vector] != 0)
+    {
+        EndCriticalSection(IBit_State);
+        return NO_ERROR;
+    }
+
+    if (numberOfProfiles >= MAX_PROFILED_IRQS)
+    {
+        EndCriticalSection(IBit_State);
+        return REGISTRY_FULL;
+    }
+
+    irq_profile_t *p = &profiles[numberOfProfiles];
+
+    memset(p, 0, sizeof(irq_profile_t));
+    p->handler = (void (*)(void))__NVIC_GetVector(IRQn);
+    p->probe = (IRQn == SysTick_IRQn) ? SysTickLatency : 0;
+    p->stats.IRQn = IRQn;
+
+    numberOfProfiles++;
+    profileOfVector[vector] = numberOfProfiles;
+
+    __NVIC_SetVector(IRQn, (uint32_t)IrqProfileWrapper);
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Sets the handler of a vector, behind the wrapper if the vector is profiled
+ */
+void G8RTOS_SetProfiledVector(IRQn_Type IRQn, void (*handler)(void))
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    irq_profile_t *p = FindProfile(IRQn);
+
+    if (p)
+    {
+        p->handler = handler;
+    }
+    else
+    {
+        __NVIC_SetVector(IRQn, (uint32_t)handler);
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Sets the function that measures the entry latency of a profiled vector
+ */
+sched_ErrCode_t G8RTOS_SetIrqLatencyProbe(IRQn_Type IRQn, uint32_t (*probe)(void))
+{
+    irq_profile_t *p = FindProfile(IRQn);
+
+    if (!p)
+    {
+        return IRQn_INVALID;
+    }
+
+    p->probe = probe;
+
+    return NO_ERROR;
+}
+
+/*
+ * Copies the statistics of a profiled vector
+ */
+sched_ErrCode_t G8RTOS_GetIrqStats(IRQn_Type IRQn, irq_stats_t *stats)
+{
+    irq_profile_t *p = FindProfile(IRQn);
+
+    if (!p)
+    {
+        return IRQn_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+    *stats = p->stats;
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Clears the statistics of every profiled vector
+ */
+void G8RTOS_ResetIrqStats()
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < numberOfProfiles; i++)
+    {
+        int32_t IBit_State = StartCriticalSection();
+
+        IRQn_Type IRQn = profiles[i].stats.IRQn;
+        memset(&profiles[i].stats, 0, sizeof(irq_stats_t));
+        profiles[i].stats.IRQn = IRQn;
+
+        EndCriticalSection(IBit_State);
+    }
+}
+
+/*
+ * Writes the statistics of every profiled vector to the back channel UART
+ */
+void G8RTOS_DumpIrqStats()
+{
+    irq_stats_t stats;
+    char output[IRQ_OUTPUT_LENGTH];
+    uint32_t i = 0;
+
+    for (i = 0; i < numberOfProfiles; i++)
+    {
+        G8RTOS_GetIrqStats(profiles[i].stats.IRQn, &stats);
+
+        snprintf(output, IRQ_OUTPUT_LENGTH, "irq %d: count %u worst %u cyc\r\n",
+                 (int)stats.IRQn, (unsigned int)stats.count, (unsigned int)stats.worstDuration);
+        BackChannelWrite(output);
+        DumpHistogram("  duration", stats.duration);
+
+        if (stats.latencyCount != 0)
+        {
+            snprintf(output, IRQ_OUTPUT_LENGTH, "  latency count %u worst %u cyc\r\n",
+                     (unsigned int)stats.latencyCount, (unsigned int)stats.worstLatency);
+            BackChannelWrite(output);
+            DumpHistogram("  latency", stats.latency);
+        }
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_IRQ_PROFILE */
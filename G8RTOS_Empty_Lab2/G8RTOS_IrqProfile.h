@@ -0,0 +1,103 @@
+/*
+ * G8RTOS_IrqProfile.h
+ *
+ * Interrupt duration and entry latency histograms
+ *  - Only compiled in when the project is built with G8RTOS_IRQ_PROFILE defined
+ *  - A profiled vector in the relocated table points at a wrapper that times the original handler with DWT cycles
+ *  - G8RTOS_Init profiles IRQ_PROFILE_DEFAULT_IRQS, the dispatch layer keeps the wrapper in place
+ *    when a handler is installed on a profiled vector
+ *  - Durations include the time spent in higher priority interrupts that preempted the handler
+ *  - Entry latency needs the time the request was raised, which the NVIC does not keep.
+ *    It is measured for SysTick from its counter, other sources can supply it with G8RTOS_SetIrqLatencyProbe
+ */
+
+#ifndef G8RTOS_IRQPROFILE_H_
+#define G8RTOS_IRQPROFILE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Maximum number of vectors that can be profiled at once */
+#define MAX_PROFILED_IRQS 8
+
+/*
+ * Histogram bucket 0 counts 0 cycles, bucket n counts [2^(n-1), 2^n) cycles,
+ * the last bucket also counts everything above its range (2^18 cycles is about 5.5 ms at 48 MHz)
+ */
+#define IRQ_HISTOGRAM_BUCKETS 20
+
+/* Vectors profiled from G8RTOS_Init: SysTick, CC3100 (PORT2), I2C sensors (EUSCIB1) and LCD SPI (EUSCIB3) */
+#define IRQ_PROFILE_DEFAULT_IRQS { SysTick_IRQn, PORT2_IRQn, EUSCIB1_IRQn, EUSCIB3_IRQn }
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Statistics of one profiled vector, all times in MCLK cycles
+ *  - latencyCount stays 0 for sources without a latency probe
+ */
+typedef struct irq_stats_t {
+    IRQn_Type IRQn;
+    uint32_t count;
+    uint32_t worstDuration;
+    uint32_t duration[IRQ_HISTOGRAM_BUCKETS];
+    uint32_t latencyCount;
+    uint32_t worstLatency;
+    uint32_t latency[IRQ_HISTOGRAM_BUCKETS];
+} irq_stats_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Wraps the handler in the relocated vector table with the profiling wrapper
+ *  - PendSV and the fault vectors can not be profiled, the wrapper would change the stack the context switch uses
+ * Param "IRQn": SysTick_IRQn or a peripheral interrupt
+ * Returns: IRQn_INVALID for other vectors, REGISTRY_FULL if MAX_PROFILED_IRQS are already profiled
+ */
+sched_ErrCode_t G8RTOS_ProfileIRQ(IRQn_Type IRQn);
+
+/*
+ * Sets the handler of a vector, behind the wrapper if the vector is profiled
+ *  - Used by the dispatch layer (G8RTOS_Dispatch.c)
+ * Param "IRQn": Vector to set
+ * Param "handler": Interrupt handler
+ */
+void G8RTOS_SetProfiledVector(IRQn_Type IRQn, void (*handler)(void));
+
+/*
+ * Sets the function that measures the entry latency of a profiled vector
+ *  - Called first thing in the wrapper, returns MCLK cycles since the interrupt request was raised
+ *    e.g. from a Timer_A counter that was captured or reset by the event
+ * Param "IRQn": Profiled vector
+ * Param "probe": Latency function, 0 to stop measuring latency
+ * Returns: IRQn_INVALID if the vector is not profiled
+ */
+sched_ErrCode_t G8RTOS_SetIrqLatencyProbe(IRQn_Type IRQn, uint32_t (*probe)(void));
+
+/*
+ * Copies the statistics of a profiled vector
+ * Returns: IRQn_INVALID if the vector is not profiled
+ */
+sched_ErrCode_t G8RTOS_GetIrqStats(IRQn_Type IRQn, irq_stats_t *stats);
+
+/*
+ * Clears the statistics of every profiled vector
+ */
+void G8RTOS_ResetIrqStats();
+
+/*
+ * Writes count, worst case and the non-empty histogram buckets of every profiled vector to the back channel UART
+ */
+void G8RTOS_DumpIrqStats();
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_IRQPROFILE_H_ */
@@ -0,0 +1,264 @@
+/*
+ * G8RTOS_MPU.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_MPU.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+
+/* Defined in G8RTOS_Scheduler.c */
+extern tcb_t * CurrentlyRunningThread;
+
+/* Process stack pointer access, in G8RTOS_SchedulerASM.s */
+extern uint32_t G8RTOS_GetPSP();
+extern void G8RTOS_SetPSP(uint32_t psp);
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#ifdef G8RTOS_MPU
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Memory map, from msp432p401r.cmd */
+#define MPU_FLASH_BASE 0x00000000
+#define MPU_SRAM_CODE_BASE 0x01000000
+#define MPU_SRAM_BASE 0x20000000
+#define MPU_SRAM_SIZE 0x00010000
+
+/* Subregions used to cover the stacks: 8 KB of the whole SRAM, 1 KB of an 8 KB block at either end */
+#define MPU_SRAM_SUBREGION 0x2000
+#define MPU_EDGE_SUBREGION 0x0400
+
+/* MMFSR bits of SCB->CFSR */
+#define MMFSR_MSTKERR 0x10
+#define MMFSR_MMARVALID 0x80
+
+#define MPU_FAULT_OUTPUT_LENGTH 80
+
+static mpu_fault_t lastFault;
+static uint32_t numberOfFaults = 0;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Subregion disable bits for the part of a region outside of [base, end)
+ */
+static uint32_t SubregionsOutside(uint32_t regionBase, uint32_t subregionSize, uint32_t base, uint32_t end)
+{
+    uint32_t disable = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        uint32_t start = regionBase + i * subregionSize;
+        if (start < base || start + subregionSize > end)
+        {
+            disable |= (MPU_SUB_RGN_DISABLE_0 << i);
+        }
+    }
+
+    return disable;
+}
+
+/*
+ * Programs a read only region, or disables it if every subregion is disabled
+ */
+static void SetReadOnlyRegion(uint32_t region, uint32_t regionBase, uint32_t size, uint32_t disable)
+{
+    if (disable == (MPU_SUB_RGN_DISABLE_0 * 0xFF))
+    {
+        MPU_setRegion(region, regionBase, MPU_RGN_DISABLE);
+        return;
+    }
+
+    MPU_setRegion(region, regionBase, size | disable | MPU_RGN_PERM_NOEXEC | MPU_RGN_PERM_PRV_RO_USR_RO |
+                  MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE);
+}
+
+/*
+ * Makes [base, end) read only with the three stack regions
+ *  - The stacks are 2 KB aligned, so 8 KB subregions of the whole SRAM cover their middle and
+ *    1 KB subregions of the 8 KB blocks holding base and end cover both ends exactly
+ */
+static void CoverStacks(uint32_t base, uint32_t end)
+{
+    uint32_t lowBlock = base & ~(MPU_SRAM_SUBREGION - 1);
+    uint32_t highBlock = (end - 1) & ~(MPU_SRAM_SUBREGION - 1);
+
+    SetReadOnlyRegion(MPU_REGION_STACKS, MPU_SRAM_BASE, MPU_RGN_SIZE_64K,
+                      SubregionsOutside(MPU_SRAM_BASE, MPU_SRAM_SUBREGION, base, end));
+    SetReadOnlyRegion(MPU_REGION_STACKS + 1, lowBlock, MPU_RGN_SIZE_8K,
+                      SubregionsOutside(lowBlock, MPU_EDGE_SUBREGION, base, end));
+    SetReadOnlyRegion(MPU_REGION_STACKS + 2, highBlock, MPU_RGN_SIZE_8K,
+                      SubregionsOutside(highBlock, MPU_EDGE_SUBREGION, base, end));
+}
+
+/*
+ * Records a fault and writes it to the back channel UART
+ */
+static void ReportFault(const char *where, uint32_t status, uint32_t pc)
+{
+    char output[MPU_FAULT_OUTPUT_LENGTH];
+
+    lastFault.threadId = CurrentlyRunningThread->threadId;
+    memcpy(lastFault.threadName, CurrentlyRunningThread->threadName, MAX_NAME_LENGTH);
+    lastFault.threadName[MAX_NAME_LENGTH-1] = 0;
+    lastFault.status = status;
+    lastFault.address = (status & MMFSR_MMARVALID) ? SCB->MMFAR : 0;
+    lastFault.pc = pc;
+    numberOfFaults++;
+
+    snprintf(output, MPU_FAULT_OUTPUT_LENGTH, "MPU fault %s %s: status %02x address %08x pc %08x\r\n",
+             where, lastFault.threadName, (unsigned int)status, (unsigned int)lastFault.address, (unsigned int)pc);
+    BackChannelWrite(output);
+}
+
+/*
+ * Halts after a fault the kernel can not recover from
+ */
+static void HaltOnFault()
+{
+    asm("   CPSID   I ");
+    while(1);
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Programs the fixed regions and enables the MPU and the MemManage fault
+ */
+void G8RTOS_InitMPU(uint32_t stacksBase, uint32_t stacksSize)
+{
+    MPU_disableModule();
+
+    /* code: read only, executable */
+    MPU_setRegion(MPU_REGION_FLASH, MPU_FLASH_BASE, MPU_RGN_SIZE_256K | MPU_RGN_PERM_EXEC |
+                  MPU_RGN_PERM_PRV_RO_USR_RO | MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE);
+    MPU_setRegion(MPU_REGION_SRAM_CODE, MPU_SRAM_CODE_BASE, MPU_RGN_SIZE_64K | MPU_RGN_PERM_EXEC |
+                  MPU_RGN_PERM_PRV_RO_USR_RO | MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE);
+
+    /* shared data: read/write, not executable */
+    MPU_setRegion(MPU_REGION_SRAM_DATA, MPU_SRAM_BASE, MPU_RGN_SIZE_64K | MPU_RGN_PERM_NOEXEC |
+                  MPU_RGN_PERM_PRV_RW_USR_RW | MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE);
+
+    /* every stack read only, the running thread's stack is mapped on top by PendSV_Handler */
+    CoverStacks(stacksBase, stacksBase + stacksSize);
+    MPU_setRegion(MPU_REGION_OWN_STACK, stacksBase, MPU_RGN_DISABLE);
+
+    /* the first stack has no stack below it to run into */
+    MPU_setRegion(MPU_REGION_GUARD, stacksBase, MPU_RGN_SIZE_32B | MPU_RGN_PERM_NOEXEC |
+                  MPU_RGN_PERM_PRV_RO_USR_RO | MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE);
+
+    /* everything else keeps the default memory map */
+    MPU_enableModule(MPU_CONFIG_PRIV_DEFAULT);
+    MPU_enableInterrupt();
+    asm("   DSB ");
+    asm("   ISB ");
+}
+
+/*
+ * Turns the MPU off so the kernel can set up the stack of a new thread
+ */
+uint32_t G8RTOS_MPUUnlock()
+{
+    uint32_t state = MPU->CTRL;
+
+    MPU->CTRL = state & ~MPU_CTRL_ENABLE_Msk;
+
+    return state;
+}
+
+/*
+ * Puts the MPU back the way G8RTOS_MPUUnlock found it
+ *  - Threads added before G8RTOS_Launch find the MPU off, enabling it without regions would fault
+ */
+void G8RTOS_MPULock(uint32_t state)
+{
+    MPU->CTRL = state;
+    asm("   DSB ");
+    asm("   ISB ");
+}
+
+/*
+ * Copies the last MPU fault
+ */
+uint32_t G8RTOS_GetMPUFault(mpu_fault_t *fault)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    *fault = lastFault;
+    uint32_t count = numberOfFaults;
+
+    EndCriticalSection(IBit_State);
+
+    return count;
+}
+
+/*
+ * MemManage fault
+ *  - A fault taken from a thread kills that thread, PendSV is already pending and switches away from it
+ *    before the faulting instruction could run again
+ *  - The dead thread's PSP is moved to the top of its stack so PendSV can save its registers there
+ *  - A fault inside an interrupt handler halts
+ */
+void MemManage_Handler()
+{
+    uint32_t status = SCB->CFSR & 0xFF;
+    uint32_t pc = 0;
+    bool fromThread = (SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) != 0;
+
+    /* the stacked frame holds the faulting pc, unless stacking is what faulted */
+    if (fromThread && !(status & MMFSR_MSTKERR))
+    {
+        pc = ((uint32_t *)G8RTOS_GetPSP())[6];
+    }
+
+    ReportFault(fromThread ? "in thread" : "in handler, thread", status, pc);
+    SCB->CFSR = status;
+
+    if (!fromThread || G8RTOS_KillThread(CurrentlyRunningThread->threadId) != NO_ERROR)
+    {
+        HaltOnFault();
+    }
+
+    MPU->RNR = MPU_REGION_OWN_STACK;
+    G8RTOS_SetPSP((MPU->RBAR & MPU_RBAR_ADDR_Msk) + MPU_STACK_REGION_SIZE - 64);
+}
+
+/*
+ * HardFault
+ *  - MemManage faults with interrupts masked end up here
+ */
+void HardFault_Handler()
+{
+    uint32_t status = SCB->CFSR & 0xFF;
+
+    if (status != 0)
+    {
+        ReportFault("with interrupts masked, thread", status, 0);
+    }
+    else
+    {
+        BackChannelWrite("HardFault\r\n");
+    }
+
+    HaltOnFault();
+}
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_MPU */
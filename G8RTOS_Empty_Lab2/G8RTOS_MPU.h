@@ -0,0 +1,103 @@
+/*
+ * G8RTOS_MPU.h
+ *
+ * Per-thread memory isolation with the MPU
+ *  - Only compiled in when the project is built with G8RTOS_MPU defined, the MPU is enabled by G8RTOS_Launch
+ *  - Fixed regions: kernel and application code in flash and in SRAM_CODE is read only,
+ *    shared data in SRAM is read/write but not executable, every thread stack is read only
+ *  - PendSV_Handler maps the stack of the thread it switches to read/write with one region (two register writes)
+ *  - A write into another thread's stack, a stack overflow or code fetched from SRAM raises a MemManage fault.
+ *    The fault is reported on the back channel UART with the thread name and the thread is killed
+ *  - Threads run privileged and call the kernel directly, so kernel data (TCBs, semaphores, FIFOs) has to stay
+ *    writable and is only protected as part of the shared data
+ *  - A fault while interrupts are masked escalates to a HardFault, which is reported and halts
+ */
+
+#ifndef G8RTOS_MPU_H_
+#define G8RTOS_MPU_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "driverlib.h"
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Regions, a higher number wins where regions overlap */
+#define MPU_REGION_FLASH 0
+#define MPU_REGION_SRAM_CODE 1
+#define MPU_REGION_SRAM_DATA 2
+#define MPU_REGION_STACKS 3             // 3 to 5 cover all thread stacks read only
+#define MPU_REGION_OWN_STACK 6
+#define MPU_REGION_GUARD 7              // bottom of the first stack, nothing below it is a stack
+
+/* Every thread stack is one region, so its size must be a power of two and the stacks aligned to it */
+#define MPU_STACK_REGION_SIZE 2048
+#define MPU_STACK_REGION_FLAGS (MPU_RGN_SIZE_2K | MPU_RGN_PERM_NOEXEC | MPU_RGN_PERM_PRV_RW_USR_RW | MPU_SRAM_ATTRIBUTES | MPU_RGN_ENABLE)
+
+/* Normal, cacheable, bufferable, shareable: the attributes of internal SRAM and flash */
+#define MPU_SRAM_ATTRIBUTES (MPU_RASR_C_Msk | MPU_RASR_B_Msk | MPU_RASR_S_Msk)
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Last MPU fault
+ *  - pc is 0 when the exception frame itself could not be stacked
+ *  - address is 0 when the MPU did not record the data address
+ */
+typedef struct mpu_fault_t {
+    threadId_t threadId;
+    char threadName[MAX_NAME_LENGTH];
+    uint32_t status;        // MMFSR bits of SCB->CFSR
+    uint32_t address;
+    uint32_t pc;
+} mpu_fault_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Programs the fixed regions and enables the MPU and the MemManage fault
+ * Param "stacksBase": Address of the first thread stack, aligned to 2 KB
+ * Param "stacksSize": Size of all thread stacks in bytes
+ */
+void G8RTOS_InitMPU(uint32_t stacksBase, uint32_t stacksSize);
+
+/*
+ * Maps a thread stack read/write, called by PendSV_Handler for every switch
+ * Param "stackBase": Address of the stack, aligned to MPU_STACK_REGION_SIZE
+ */
+static inline void G8RTOS_MPUMapStack(uint32_t stackBase)
+{
+    MPU->RBAR = stackBase | MPU_RBAR_VALID_Msk | MPU_REGION_OWN_STACK;
+    MPU->RASR = MPU_STACK_REGION_FLAGS;
+}
+
+/*
+ * Turns the MPU off so the kernel can set up the stack of a new thread
+ *  - Must be called inside of a critical section, followed by G8RTOS_MPULock
+ * Returns: MPU control register before the call, for G8RTOS_MPULock
+ */
+uint32_t G8RTOS_MPUUnlock();
+
+/*
+ * Puts the MPU back the way G8RTOS_MPUUnlock found it
+ *  - Before G8RTOS_InitMPU the MPU stays off, it has no regions to enforce yet
+ * Param "state": Value returned by G8RTOS_MPUUnlock
+ */
+void G8RTOS_MPULock(uint32_t state);
+
+/*
+ * Copies the last MPU fault
+ * Returns: Number of MPU faults since launch
+ */
+uint32_t G8RTOS_GetMPUFault(mpu_fault_t *fault);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_MPU_H_ */
@@ -0,0 +1,276 @@
+/*
+ * G8RTOS_Memory.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "G8RTOS_Memory.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Registered pools, sorted by ascending block size */
+static pool_t * registeredPools[MAX_REGISTERED_POOLS];
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Number of pools in registeredPools */
+static uint32_t NumberOfPools;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Checks that a pointer is the start of a block inside of a pool
+ */
+static inline int32_t IsBlockOfPool(pool_t *pool, void *block)
+{
+    uint8_t * pt = (uint8_t *)block;
+
+    if (pt < pool->start || pt >= pool->end)
+    {
+        return 0;
+    }
+
+    return (((uint32_t)(pt - pool->start) % pool->blockSize) == 0);
+}
+
+/*
+ * Index of a block in its pool
+ */
+static inline uint32_t BlockIndex(pool_t *pool, void *block)
+{
+    return (uint32_t)((uint8_t *)block - pool->start) / pool->blockSize;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Initializes a pool over a static buffer
+ *  - Threads every block onto the free list
+ */
+pool_ErrCode_t G8RTOS_InitPool(pool_t *pool, uint32_t *storage, uint32_t blockSize, uint32_t numBlocks, const char *name)
+{
+    if (pool == 0 || storage == 0 || blockSize == 0 || numBlocks == 0 || numBlocks > POOL_MAX_BLOCKS)
+    {
+        return POOL_INVALID_ARGUMENTS;
+    }
+
+    uint32_t blockWords = POOL_BLOCK_WORDS(blockSize);
+    uint32_t i = 0;
+
+    int32_t IBit_State = StartCriticalSection();
+
+    pool->blockSize = blockWords * 4;
+    pool->numBlocks = numBlocks;
+    pool->start = (uint8_t *)storage;
+    pool->end = (uint8_t *)(storage + (blockWords * numBlocks));
+    pool->name = name;
+
+    /* every block points to the one after it, the last one ends the list */
+    for (i = 0; i < numBlocks - 1; i++)
+    {
+        *((uint32_t **)&storage[i * blockWords]) = &storage[(i + 1) * blockWords];
+    }
+    *((uint32_t **)&storage[i * blockWords]) = 0;
+    pool->freeList = storage;
+
+    for (i = 0; i < POOL_MAP_WORDS; i++)
+    {
+        pool->inUseMap[i] = 0;
+    }
+
+    pool->inUse = 0;
+    pool->peakInUse = 0;
+    pool->allocCount = 0;
+    pool->freeCount = 0;
+    pool->failCount = 0;
+
+    EndCriticalSection(IBit_State);
+
+    return POOL_NO_ERROR;
+}
+
+/*
+ * Takes a block out of a pool
+ *  - Pops the head of the free list
+ */
+void * G8RTOS_PoolAlloc(pool_t *pool)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t * block = pool->freeList;
+
+    if (block == 0)
+    {
+        pool->failCount++;
+        EndCriticalSection(IBit_State);
+        return 0;
+    }
+
+    pool->freeList = *((uint32_t **)block);
+
+    uint32_t index = BlockIndex(pool, block);
+    pool->inUseMap[index / 32] |= (1u << (index % 32));
+
+    pool->allocCount++;
+    pool->inUse++;
+    if (pool->inUse > pool->peakInUse)
+    {
+        pool->peakInUse = pool->inUse;
+    }
+
+    EndCriticalSection(IBit_State);
+
+    return block;
+}
+
+/*
+ * Returns a block to its pool
+ *  - Pushes the block onto the head of the free list
+ *  - A block whose in-use bit is clear is already on the free list, pushing it again would make the list a cycle
+ */
+pool_ErrCode_t G8RTOS_PoolFree(pool_t *pool, void *block)
+{
+    if (!IsBlockOfPool(pool, block))
+    {
+        return POOL_INVALID_BLOCK;
+    }
+
+    uint32_t index = BlockIndex(pool, block);
+    uint32_t mask = 1u << (index % 32);
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if ((pool->inUseMap[index / 32] & mask) == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return POOL_DOUBLE_FREE;
+    }
+
+    pool->inUseMap[index / 32] &= ~mask;
+
+    *((uint32_t **)block) = pool->freeList;
+    pool->freeList = (uint32_t *)block;
+
+    pool->freeCount++;
+    pool->inUse--;
+
+    EndCriticalSection(IBit_State);
+
+    return POOL_NO_ERROR;
+}
+
+/*
+ * Copies the statistics of a pool
+ */
+void G8RTOS_GetPoolStats(pool_t *pool, pool_stats_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    stats->blockSize = pool->blockSize;
+    stats->numBlocks = pool->numBlocks;
+    stats->inUse = pool->inUse;
+    stats->peakInUse = pool->peakInUse;
+    stats->allocCount = pool->allocCount;
+    stats->freeCount = pool->freeCount;
+    stats->failCount = pool->failCount;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Registers a pool with the size-class allocator
+ *  - Insertion sort by block size so G8RTOS_Malloc finds the best fit first
+ */
+pool_ErrCode_t G8RTOS_RegisterPool(pool_t *pool)
+{
+    if (pool == 0 || pool->blockSize == 0)
+    {
+        return POOL_INVALID_ARGUMENTS;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if (NumberOfPools >= MAX_REGISTERED_POOLS)
+    {
+        EndCriticalSection(IBit_State);
+        return POOL_REGISTRY_FULL;
+    }
+
+    int32_t i = NumberOfPools;
+    while (i > 0 && registeredPools[i-1]->blockSize > pool->blockSize)
+    {
+        registeredPools[i] = registeredPools[i-1];
+        i--;
+    }
+    registeredPools[i] = pool;
+    NumberOfPools++;
+
+    EndCriticalSection(IBit_State);
+
+    return POOL_NO_ERROR;
+}
+
+/*
+ * Allocates from the smallest registered pool whose blocks fit the request
+ *  - Bounded by MAX_REGISTERED_POOLS
+ */
+void * G8RTOS_Malloc(uint32_t size)
+{
+    uint32_t i = 0;
+    void * block = 0;
+
+    for (i = 0; i < NumberOfPools; i++)
+    {
+        if (registeredPools[i]->blockSize >= size)
+        {
+            block = G8RTOS_PoolAlloc(registeredPools[i]);
+            if (block != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    return block;
+}
+
+/*
+ * Returns a block obtained from G8RTOS_Malloc to the pool that owns it
+ *  - The owner is found by address range, bounded by MAX_REGISTERED_POOLS
+ */
+pool_ErrCode_t G8RTOS_Free(void *block)
+{
+    uint32_t i = 0;
+
+    if (block == 0)
+    {
+        return POOL_NO_ERROR;
+    }
+
+    for (i = 0; i < NumberOfPools; i++)
+    {
+        if (IsBlockOfPool(registeredPools[i], block))
+        {
+            return G8RTOS_PoolFree(registeredPools[i], block);
+        }
+    }
+
+    return POOL_NOT_REGISTERED;
+}
+
+/*********************************************** Public Functions *********************************************************************/
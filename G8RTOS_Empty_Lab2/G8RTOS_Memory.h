@@ -0,0 +1,149 @@
+/*
+ * G8RTOS_Memory.h
+ *
+ * Fixed-block memory pools
+ *  - Every pool hands out blocks of a single size from a caller supplied static buffer
+ *  - Allocation and free are O(1) (singly linked free list threaded through the free blocks)
+ *  - No fragmentation: a freed block is immediately reusable by the next allocation of that pool
+ *  - Allocation and free are critical sections, so both may be called from threads and ISRs
+ *  - Every block has an in-use bit, freeing a block twice or a pointer no pool owns is reported, never queued
+ */
+
+#ifndef G8RTOS_MEMORY_H_
+#define G8RTOS_MEMORY_H_
+
+#include <stdint.h>
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Maximum number of pools that can be registered with G8RTOS_Malloc / G8RTOS_Free */
+#define MAX_REGISTERED_POOLS 8
+
+/* Maximum number of blocks in one pool, bounds the in-use bitmap of every pool */
+#define POOL_MAX_BLOCKS 256
+#define POOL_MAP_WORDS ((POOL_MAX_BLOCKS + 31) / 32)
+
+/*
+ * Number of 32-bit words of storage needed for a pool
+ * Use it to declare the static backing buffer of a pool:
+ *      static uint32_t ballStorage[POOL_STORAGE_WORDS(sizeof(ball_t), MAX_NUM_OF_BALLS)];
+ */
+#define POOL_BLOCK_WORDS(blockSize) ((((blockSize) + 3) / 4) < 1 ? 1 : (((blockSize) + 3) / 4))
+#define POOL_STORAGE_WORDS(blockSize, numBlocks) ((numBlocks) * POOL_BLOCK_WORDS(blockSize))
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/*********************************************** Datatype Definitions *****************************************************************/
+
+typedef enum {
+    POOL_NO_ERROR = 0,
+    POOL_INVALID_ARGUMENTS = -1,
+    POOL_INVALID_BLOCK = -2,
+    POOL_REGISTRY_FULL = -3,
+    POOL_NOT_REGISTERED = -4,
+    POOL_DOUBLE_FREE = -5
+} pool_ErrCode_t;
+
+/*
+ * Fixed-block pool
+ *  - freeList points at the first free block; each free block holds a pointer to the next one
+ *  - start/end bound the storage so frees can be validated and G8RTOS_Free can find the owner
+ *  - inUseMap has one bit per block, set while the block is allocated
+ *  - the remaining fields are statistics, updated on every allocation and free
+ */
+typedef struct pool_t {
+    uint32_t * freeList;
+    uint8_t * start;
+    uint8_t * end;
+    uint32_t blockSize;
+    uint32_t numBlocks;
+    uint32_t inUseMap[POOL_MAP_WORDS];
+    uint32_t inUse;
+    uint32_t peakInUse;
+    uint32_t allocCount;
+    uint32_t freeCount;
+    uint32_t failCount;
+    const char * name;
+} pool_t;
+
+/*
+ * Snapshot of the statistics of one pool
+ */
+typedef struct pool_stats_t {
+    uint32_t blockSize;
+    uint32_t numBlocks;
+    uint32_t inUse;
+    uint32_t peakInUse;
+    uint32_t allocCount;
+    uint32_t freeCount;
+    uint32_t failCount;
+} pool_stats_t;
+
+/*********************************************** Datatype Definitions *****************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Initializes a pool over a static buffer
+ * Param "pool": Pool to initialize
+ * Param "storage": Backing buffer of at least POOL_STORAGE_WORDS(blockSize, numBlocks) words
+ * Param "blockSize": Size in bytes of every block (rounded up to a multiple of 4)
+ * Param "numBlocks": Number of blocks in the pool, at most POOL_MAX_BLOCKS
+ * Param "name": Name of the pool, used for diagnostics
+ * Returns: Error code for initializing the pool
+ */
+pool_ErrCode_t G8RTOS_InitPool(pool_t *pool, uint32_t *storage, uint32_t blockSize, uint32_t numBlocks, const char *name);
+
+/*
+ * Takes a block out of a pool
+ * Param "pool": Pool to allocate from
+ * Returns: Pointer to the block, or 0 if the pool is empty
+ * THIS IS A CRITICAL SECTION
+ */
+void * G8RTOS_PoolAlloc(pool_t *pool);
+
+/*
+ * Returns a block to its pool
+ *  - Safe to call from an ISR
+ * Param "pool": Pool the block was allocated from
+ * Param "block": Block to release
+ * Returns: Error code for releasing the block, POOL_DOUBLE_FREE if it is not allocated
+ * THIS IS A CRITICAL SECTION
+ */
+pool_ErrCode_t G8RTOS_PoolFree(pool_t *pool, void *block);
+
+/*
+ * Copies the statistics of a pool
+ * Param "pool": Pool to read
+ * Param "stats": Where to store the statistics
+ */
+void G8RTOS_GetPoolStats(pool_t *pool, pool_stats_t *stats);
+
+/*
+ * Registers a pool with the size-class allocator (G8RTOS_Malloc / G8RTOS_Free)
+ *  - Pools are kept sorted by block size
+ * Param "pool": Initialized pool to register
+ * Returns: Error code for registering the pool
+ */
+pool_ErrCode_t G8RTOS_RegisterPool(pool_t *pool);
+
+/*
+ * Allocates from the smallest registered pool whose blocks fit the request
+ *  - Falls through to the next size class if the best fitting pool is empty
+ * Param "size": Number of bytes needed
+ * Returns: Pointer to the block, or 0 if no registered pool can satisfy the request
+ */
+void * G8RTOS_Malloc(uint32_t size);
+
+/*
+ * Returns a block obtained from G8RTOS_Malloc to the pool that owns it
+ *  - Safe to call from an ISR
+ * Param "block": Block to release (0 is ignored)
+ * Returns: Error code for releasing the block, POOL_NOT_REGISTERED if no registered pool owns it
+ */
+pool_ErrCode_t G8RTOS_Free(void *block);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_MEMORY_H_ */
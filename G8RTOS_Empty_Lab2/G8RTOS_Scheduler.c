@@ -5,10 +5,18 @@
 /*********************************************** Dependencies and Externs *************************************************************/
 
 #include <stdint.h>
+#include <string.h>
 #include "msp.h"
 #include "BSP.h"
+#include "RamFunc.h"
 #include "G8RTOS_Scheduler.h"
 #include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_Supervisor.h"
+#include "G8RTOS_Static.h"
+#include "G8RTOS_IrqProfile.h"
+#include "G8RTOS_MPU.h"
+#include "G8RTOS_Dispatch.h"
 
 /*
  * G8RTOS_Start exists in asm
@@ -31,25 +39,96 @@ tcb_t * CurrentlyRunningThread;
 /* Status Register with the Thumb-bit Set */
 #define THUMBBIT 0x01000000
 
+/* Pattern unused stack words are painted with to find the high water mark */
+#define STACK_PAINT 0xCDCDCDCD
+
 /*********************************************** Defines ******************************************************************************/
 
 
 /*********************************************** Data Structures Used *****************************************************************/
 
-/* Thread Control Blocks
- *	- An array of thread control blocks to hold pertinent information for each thread
+#ifdef G8RTOS_STATIC_CONFIG
+
+/*
+ * Initial stack frame of a static thread, the same one G8RTOS_AddThread builds:
+ * psr, pc and lr at the top followed by room for the 13 remaining registers
  */
-static tcb_t threadControlBlocks[MAX_THREADS];
+#define G8RTOS_STATIC_STACK(fn, prio, nm) \
+    [G8RTOS_THREAD_SLOT_##fn] = { \
+        .lr = fn, \
+        .pc = fn, \
+        .psr = THUMBBIT \
+    },
+
+/* Static threads form a ring in the order they are listed */
+#define G8RTOS_STATIC_TCB(fn, prio, nm) \
+    [G8RTOS_THREAD_SLOT_##fn] = { \
+        .sp = &threadStacks[G8RTOS_THREAD_SLOT_##fn].words[STACKSIZE-16], \
+        .next = &threadControlBlocks[(G8RTOS_THREAD_SLOT_##fn + 1) % G8RTOS_STATIC_THREAD_COUNT], \
+        .prev = &threadControlBlocks[(G8RTOS_THREAD_SLOT_##fn + G8RTOS_STATIC_THREAD_COUNT - 1) % G8RTOS_STATIC_THREAD_COUNT], \
+        .isAlive = true, \
+        .priority = (prio), \
+        .threadName = nm, \
+        .threadId = (G8RTOS_THREAD_SLOT_##fn << 16) | G8RTOS_THREAD_SLOT_##fn \
+    },
+
+/* Static events form a ring in the order they are listed, first release one period after launch */
+#define G8RTOS_STATIC_PTCB(fn, per) \
+    [G8RTOS_EVENT_SLOT_##fn] = { \
+        .handler = fn, \
+        .period = (per), \
+        .execute_time = (per), \
+        .prev = &Pthread[(G8RTOS_EVENT_SLOT_##fn + G8RTOS_STATIC_EVENT_COUNT - 1) % G8RTOS_STATIC_EVENT_COUNT], \
+        .next = &Pthread[(G8RTOS_EVENT_SLOT_##fn + 1) % G8RTOS_STATIC_EVENT_COUNT] \
+    },
+
+#endif /* G8RTOS_STATIC_CONFIG */
+
+/* Thread Stack
+ *	- STACKSIZE words, the top three name the slots of the initial lr, pc and psr
+ *	  so a static frame can be written as constant data
+ */
+typedef struct threadStack_t {
+    int32_t words[STACKSIZE-3];
+    void (*lr)(void);
+    void (*pc)(void);
+    int32_t psr;
+} threadStack_t;
 
 /* Thread Stacks
- *	- An array of arrays that will act as individual stacks for each thread
+ *	- An array of stacks that will act as individual stacks for each thread
+ *	- With a static configuration the initial frames are data, the compressed copy table costs the
+ *	  same boot time as zeroing the array
  */
-static int32_t threadStacks[MAX_THREADS][STACKSIZE];
+#ifdef G8RTOS_MPU
+/* every stack is one MPU region */
+typedef char G8RTOS_MPU_StackSizeCheck[(sizeof(threadStack_t) == MPU_STACK_REGION_SIZE) ? 1 : -1];
+#pragma DATA_ALIGN(threadStacks, MPU_STACK_REGION_SIZE)
+#endif
+#ifdef G8RTOS_STATIC_CONFIG
+static threadStack_t threadStacks[MAX_THREADS] = { G8RTOS_STATIC_THREADS(G8RTOS_STATIC_STACK) };
+#else
+static threadStack_t threadStacks[MAX_THREADS];
+#endif
+
+/* Thread Control Blocks
+ *	- An array of thread control blocks to hold pertinent information for each thread
+ */
+#ifdef G8RTOS_STATIC_CONFIG
+static tcb_t threadControlBlocks[MAX_THREADS] = { G8RTOS_STATIC_THREADS(G8RTOS_STATIC_TCB) };
+#else
+static tcb_t threadControlBlocks[MAX_THREADS];
+#endif
 
 /* Periodic Event Threads
  * - An array of periodic events to hold pertinent information for each thread
+ * - The leading empty entry keeps the initializer valid when no event is listed
  */
+#ifdef G8RTOS_STATIC_CONFIG
+static ptcb_t Pthread[MAXPTHREADS] = { { 0 }, G8RTOS_STATIC_PERIODIC_EVENTS(G8RTOS_STATIC_PTCB) };
+#else
 static ptcb_t Pthread[MAXPTHREADS];
+#endif
 
 
 /*********************************************** Data Structures Used *****************************************************************/
@@ -60,14 +139,28 @@ static ptcb_t Pthread[MAXPTHREADS];
 /*
  * Current Number of Threads currently in the scheduler
  */
-static uint32_t NumberOfThreads;
+static uint32_t NumberOfThreads = G8RTOS_STATIC_THREAD_COUNT;
 
 /*
  * Current Number of Periodic Threads currently in the scheduler
  */
-static uint32_t NumberOfPthreads;
+static uint32_t NumberOfPthreads = G8RTOS_STATIC_EVENT_COUNT;
+
+/* Static threads use IDs below G8RTOS_STATIC_THREAD_COUNT */
+static uint16_t IDCounter = G8RTOS_STATIC_THREAD_COUNT;
+
+/*
+ * Cycles spent in threads with IDLE_PRIORITY, and the cycle count at the last context switch
+ */
+static uint32_t IdleCycles;
+static uint32_t LastSwitchCycles;
 
-static uint16_t IDCounter;
+/*
+ * Context switch trace ring, TraceCount keeps counting past TRACE_LENGTH
+ */
+static bool TraceEnabled;
+static uint32_t TraceCount;
+static trace_entry_t Trace[TRACE_LENGTH];
 
 /*********************************************** Private Variables ********************************************************************/
 
@@ -86,14 +179,48 @@ static void InitSysTick(uint32_t numCycles)
     SysTick_enableInterrupt();
 }
 
+/*
+ * Starts the DWT cycle counter used for idle time accounting
+ */
+static void InitCycleCounter()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    IdleCycles = 0;
+    LastSwitchCycles = 0;
+}
+
+/*
+ * Paints the part of a stack below its initial frame
+ */
+static void PaintStack(threadStack_t *stack)
+{
+    uint32_t i = 0;
+    for (i = 0; i < STACKSIZE-16; i++)
+    {
+        stack->words[i] = STACK_PAINT;
+    }
+}
+
 /*
  * Chooses the next thread to run.
  * Lab 2 Scheduling Algorithm:
  * 	- Simple Round Robin: Choose the next running thread by selecting the currently running thread's next pointer
  */
-void G8RTOS_Scheduler()
+RAMFUNC void G8RTOS_Scheduler()
 {
 	/* Implement This */
+    uint32_t now = DWT->CYCCNT;
+    tcb_t *previous = CurrentlyRunningThread;
+
+    previous->runCycles += now - LastSwitchCycles;
+    if (previous->priority == IDLE_PRIORITY)
+    {
+        IdleCycles += now - LastSwitchCycles;
+    }
+    LastSwitchCycles = now;
+
     tcb_t *pt = CurrentlyRunningThread->next;
     int i = 0;
     uint16_t currentMaxPriority = 256;
@@ -109,8 +236,28 @@ void G8RTOS_Scheduler()
         }
         pt = pt->next;
     }
+
+    if (TraceEnabled && CurrentlyRunningThread != previous)
+    {
+        trace_entry_t *entry = &Trace[TraceCount % TRACE_LENGTH];
+        entry->cycles = now;
+        entry->from = previous->threadId;
+        entry->to = CurrentlyRunningThread->threadId;
+        TraceCount++;
+    }
 }
 
+#ifdef G8RTOS_MPU
+/*
+ * Maps the stack of the thread chosen by G8RTOS_Scheduler read/write
+ *  - Called by PendSV_Handler after G8RTOS_Scheduler, costs one division by a constant and two MPU register writes
+ */
+RAMFUNC void G8RTOS_SwitchStackRegion()
+{
+    G8RTOS_MPUMapStack((uint32_t)&threadStacks[CurrentlyRunningThread - threadControlBlocks]);
+}
+#endif
+
 /*
  * SysTick Handler
  * Currently the Systick Handler will only increment the system time
@@ -118,9 +265,13 @@ void G8RTOS_Scheduler()
  *
  * In the future, this function will also be responsible for sleeping threads and periodic threads
  */
-void SysTick_Handler()
+RAMFUNC void SysTick_Handler()
 {
     SystemTime++;
+    if (SystemTime == 0)
+    {
+        SystemTimeOverflows++;
+    }
 
     /* check for periodic events */
     uint16_t i = 0;
@@ -130,7 +281,19 @@ void SysTick_Handler()
     {
         if (ppt->execute_time == SystemTime)
         {
-            ppt->handler();
+            if (ppt->deadline != 0)
+            {
+                /* the event was released at the start of this millisecond */
+                uint64_t releaseUs = ((((uint64_t)SystemTimeOverflows) << 32) | SystemTime) * 1000;
+
+                ppt->handler();
+
+                G8RTOS_RecordDeadline(&ppt->stats, (uint32_t)(G8RTOS_GetTimeUs() - releaseUs), 0, ppt->deadline);
+            }
+            else
+            {
+                ppt->handler();
+            }
             ppt->execute_time = SystemTime + ppt->period;
         }
         ppt = ppt->next;
@@ -143,14 +306,24 @@ void SysTick_Handler()
     {
         if (pt->asleep)
         {
-            if (pt->sleepCount <= SystemTime)
+            if (G8RTOS_TimeAfterEq(SystemTime, pt->sleepCount))
             {
+                if (pt->blocked != 0)
+                {
+                    /* timed wait expired, give up the place in the semaphore */
+                    (*pt->blocked)++;
+                    pt->blocked = 0;
+                    pt->timedOut = true;
+                }
                 pt->asleep = false;
             }
         }
         pt = pt->next;
     }
 
+    /* check thread heartbeats and kick the watchdog */
+    G8RTOS_SupervisorTick();
+
     SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
 }
 
@@ -162,6 +335,9 @@ void SysTick_Handler()
 /* Holds the current time for the whole System */
 uint32_t SystemTime;
 
+/* Number of times SystemTime has wrapped, upper 32 bits of the millisecond count */
+uint32_t SystemTimeOverflows;
+
 /*********************************************** Public Variables *********************************************************************/
 
 
@@ -175,15 +351,29 @@ void G8RTOS_Init()
 {
 	/* Implement this */
     SystemTime = 0;
-    NumberOfThreads = 0;
+    SystemTimeOverflows = 0;
+    NumberOfThreads = G8RTOS_STATIC_THREAD_COUNT;
     WDT_A->CTL = WDT_A_CTL_PW | WDT_A_CTL_HOLD;     // stop watchdog timer
     BSP_InitBoard();
 
+    /* static threads start with unpainted stacks */
+    uint32_t i = 0;
+    for (i = 0; i < G8RTOS_STATIC_THREAD_COUNT; i++)
+    {
+        PaintStack(&threadStacks[i]);
+    }
+
     // Relocate vector table to SRAM to use aperiodic events
-    uint32_t newVTORTable = 0x20000000;
-    memcpy((uint32_t *)newVTORTable, (uint32_t *)SCB->VTOR, 57*4);
-    // 57 interrupt vectors to copy
-    SCB->VTOR = newVTORTable;
+    G8RTOS_InitDispatch();
+
+#ifdef G8RTOS_IRQ_PROFILE
+    /* wrap the interrupts that most often disturb frame timing */
+    IRQn_Type profiled[] = IRQ_PROFILE_DEFAULT_IRQS;
+    for (i = 0; i < sizeof(profiled) / sizeof(profiled[0]); i++)
+    {
+        G8RTOS_ProfileIRQ(profiled[i]);
+    }
+#endif
 }
 
 /*
@@ -208,8 +398,14 @@ sched_ErrCode_t G8RTOS_Launch()
         pt = pt->next;
     }
 
+    InitCycleCounter();
     InitSysTick(0);
 
+#ifdef G8RTOS_MPU
+    G8RTOS_InitMPU((uint32_t)threadStacks, sizeof(threadStacks));
+    G8RTOS_SwitchStackRegion();
+#endif
+
     /* lowest priority */
     NVIC_SetPriority(PendSV_IRQn, OSINT_PRIORITY);
     NVIC_SetPriority(SysTick_IRQn, OSINT_PRIORITY);
@@ -294,20 +490,31 @@ sched_ErrCode_t G8RTOS_AddThread(void (*threadToAdd)(void), uint8_t priority, ch
     pt->next = next;
 
     /* initialize stack */
-    pt->sp = (&threadStacks[i][STACKSIZE]);  // plus one?
+#ifdef G8RTOS_MPU
+    uint32_t mpuState = G8RTOS_MPUUnlock();
+#endif
+    PaintStack(&threadStacks[i]);
+    pt->sp = (int32_t *)(&threadStacks[i] + 1);
     *(--pt->sp) = THUMBBIT;                    // psr
     *(--pt->sp) = ((uint32_t)(threadToAdd));   // pc
     *(--pt->sp) = ((uint32_t)(threadToAdd));   // lr
     pt->sp -= 13;
+#ifdef G8RTOS_MPU
+    G8RTOS_MPULock(mpuState);
+#endif
 
     pt->priority = priority;
-    for (i=0;i<sizeof(MAX_NAME_LENGTH);i++)
+    for (j = 0; j < MAX_NAME_LENGTH-1 && name[j] != 0; j++)
     {
-        pt->threadName[i] = name[i];
+        pt->threadName[j] = name[j];
     }
+    pt->threadName[j] = 0;
     pt->threadId = ((IDCounter++) << 16) | i;
+    pt->runCycles = 0;
     pt->blocked = 0;
     pt->asleep = 0;
+    pt->timedOut = 0;
+    pt->overruns = 0;
 
     EndCriticalSection(IBit_State);
 
@@ -338,6 +545,8 @@ sched_ErrCode_t G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t per
         pt->period = period;
         pt->current_time = SystemTime;
         pt->execute_time = pt->current_time + pt->period;
+        pt->deadline = 0;
+        memset(&pt->stats, 0, sizeof(deadline_stats_t));
 
         if (NumberOfPthreads == 0)
         {
@@ -360,22 +569,110 @@ sched_ErrCode_t G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t per
     }
 }
 
+/*
+ * Adds an aperiodic event
+ *  - The handler joins the chain of its interrupt, other drivers on the same interrupt keep their handlers
+ */
 sched_ErrCode_t G8RTOS_AddAperiodicEvent(void(*AthreadToAdd)(void), uint8_t priority, IRQn_Type IRQn)
 {
-    if (IRQn < PSS_IRQn || IRQn > PORT6_IRQn)
+    return G8RTOS_AddIrqHandler(AthreadToAdd, priority, IRQn);
+}
+
+/*
+ * Declares a deadline for a periodic event
+ *  - The time from the release of the event to the end of its handler is measured every period
+ *  - Responses longer than the deadline are counted as misses
+ * Param "PthreadToFind": handler the event was added with
+ * Param "deadlineUs": deadline in us, 0 turns measurement off
+ * Returns: Error code for setting the deadline
+ */
+sched_ErrCode_t G8RTOS_SetPeriodicEventDeadline(void (*PthreadToFind)(void), uint32_t deadlineUs)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t i = 0;
+    for (i = 0; i < NumberOfPthreads; i++)
     {
-        return IRQn_INVALID;
+        if (Pthread[i].handler == PthreadToFind)
+        {
+            Pthread[i].deadline = deadlineUs;
+            memset(&Pthread[i].stats, 0, sizeof(deadline_stats_t));
+            EndCriticalSection(IBit_State);
+            return NO_ERROR;
+        }
     }
 
-    if (priority > 6)
+    EndCriticalSection(IBit_State);
+    return EVENT_DOES_NOT_EXIST;
+}
+
+/*
+ * Copies the deadline statistics of a periodic event
+ * Param "PthreadToFind": handler the event was added with
+ * Param "stats": Where to store the statistics
+ * Returns: Error code for querying the event
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicEventStats(void (*PthreadToFind)(void), deadline_stats_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t i = 0;
+    for (i = 0; i < NumberOfPthreads; i++)
     {
-        return HWI_PRIORITY_INVALID;
+        if (Pthread[i].handler == PthreadToFind)
+        {
+            *stats = Pthread[i].stats;
+            EndCriticalSection(IBit_State);
+            return NO_ERROR;
+        }
     }
 
-    __NVIC_SetVector(IRQn, AthreadToAdd);
-    __NVIC_SetPriority(IRQn, priority);
-    __NVIC_EnableIRQ(IRQn);
+    EndCriticalSection(IBit_State);
+    return EVENT_DOES_NOT_EXIST;
+}
 
+/*
+ * Copies the handler and period of the periodic event at an index
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicEvent(uint32_t index, void (**handler)(void), uint32_t *period)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (index >= NumberOfPthreads)
+    {
+        EndCriticalSection(IBit_State);
+        return EVENT_DOES_NOT_EXIST;
+    }
+
+    *handler = Pthread[index].handler;
+    *period = Pthread[index].period;
+
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Changes the period of the periodic event at an index
+ */
+sched_ErrCode_t G8RTOS_SetPeriodicEventPeriod(uint32_t index, uint32_t period)
+{
+    if (period == 0)
+    {
+        return PERIOD_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if (index >= NumberOfPthreads)
+    {
+        EndCriticalSection(IBit_State);
+        return EVENT_DOES_NOT_EXIST;
+    }
+
+    Pthread[index].period = period;
+    Pthread[index].execute_time = SystemTime + period;
+
+    EndCriticalSection(IBit_State);
     return NO_ERROR;
 }
 
@@ -497,9 +794,215 @@ void sleep(uint32_t durationMS)
     yield();
 }
 
+/*
+ * Puts the current thread into a sleep state until an absolute time
+ *  - The thread wakes at *lastWake + periodMS, which becomes the new *lastWake
+ *  - Wake times do not depend on how long the loop body took, so the loop does not drift
+ *  - If the wake time has already passed, the missed releases are skipped and the thread
+ *    sleeps until the next release that is still in phase with *lastWake
+ *  param lastWake: time of the previous release, set to SystemTime once before the loop
+ *  param periodMS: period of the loop in ms, 0 returns at once without sleeping
+ *  Returns: number of releases that were overrun (0 if the loop kept its cadence)
+ */
+uint32_t sleepUntil(uint32_t *lastWake, uint32_t periodMS)
+{
+    uint32_t missed = 0;
+    uint32_t nextWake = *lastWake + periodMS;
+
+    if (periodMS == 0)
+    {
+        /* no period to keep, and the overrun count below would divide by it */
+        return 0;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    if (G8RTOS_TimeAfter(SystemTime, nextWake))
+    {
+        /* skip every release that already passed */
+        missed = ((SystemTime - nextWake) / periodMS) + 1;
+        nextWake += missed * periodMS;
+        CurrentlyRunningThread->overruns += missed;
+    }
+
+    *lastWake = nextWake;
+
+    if (nextWake == SystemTime)
+    {
+        /* released this very millisecond, no need to sleep */
+        EndCriticalSection(IBit_State);
+        return missed;
+    }
+
+    CurrentlyRunningThread->sleepCount = nextWake;
+    CurrentlyRunningThread->asleep = true;
+
+    EndCriticalSection(IBit_State);
+
+    yield();
+
+    return missed;
+}
+
 void yield()
 {
     SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
 }
 
+/*
+ * Copies the state of the thread in a tcb slot
+ *  - The stack high water mark is the lowest word that no longer holds the paint
+ */
+sched_ErrCode_t G8RTOS_GetThreadInfo(uint32_t slot, thread_info_t *info)
+{
+    if (slot >= MAX_THREADS)
+    {
+        return THREAD_DOES_NOT_EXIST;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+
+    tcb_t *pt = &threadControlBlocks[slot];
+
+    if (!pt->isAlive)
+    {
+        EndCriticalSection(IBit_State);
+        return THREAD_DOES_NOT_EXIST;
+    }
+
+    info->threadId = pt->threadId;
+    memcpy(info->threadName, pt->threadName, MAX_NAME_LENGTH);
+    info->threadName[MAX_NAME_LENGTH-1] = 0;
+    info->priority = pt->priority;
+    info->runCycles = pt->runCycles;
+
+    if (pt == CurrentlyRunningThread)
+    {
+        info->state = THREAD_RUNNING;
+        info->runCycles += DWT->CYCCNT - LastSwitchCycles;
+    }
+    else if (pt->blocked != 0)
+    {
+        info->state = THREAD_BLOCKED;
+    }
+    else if (pt->asleep)
+    {
+        info->state = THREAD_SLEEPING;
+    }
+    else
+    {
+        info->state = THREAD_READY;
+    }
+
+    EndCriticalSection(IBit_State);
+
+    uint32_t i = 0;
+    while (i < STACKSIZE-16 && threadStacks[slot].words[i] == STACK_PAINT)
+    {
+        i++;
+    }
+    info->stackUsed = (STACKSIZE - i) * sizeof(int32_t);
+
+    return NO_ERROR;
+}
+
+/*
+ * Changes the priority of a thread, it takes effect at the next context switch
+ */
+sched_ErrCode_t G8RTOS_SetThreadPriority(threadId_t threadId, uint8_t priority)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t i = 0;
+    for (i = 0; i < MAX_THREADS; i++)
+    {
+        if (threadControlBlocks[i].isAlive && threadControlBlocks[i].threadId == threadId)
+        {
+            threadControlBlocks[i].priority = priority;
+            EndCriticalSection(IBit_State);
+            return NO_ERROR;
+        }
+    }
+
+    EndCriticalSection(IBit_State);
+    return THREAD_DOES_NOT_EXIST;
+}
+
+/*
+ * Turns the context switch trace on (clearing it) or off
+ */
+void G8RTOS_SetTrace(bool on)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (on)
+    {
+        TraceCount = 0;
+    }
+    TraceEnabled = on;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Copies the recorded context switches, oldest first
+ */
+uint32_t G8RTOS_GetTrace(trace_entry_t *entries)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t count = (TraceCount < TRACE_LENGTH) ? TraceCount : TRACE_LENGTH;
+    uint32_t first = TraceCount - count;
+    uint32_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        entries[i] = Trace[(first + i) % TRACE_LENGTH];
+    }
+
+    EndCriticalSection(IBit_State);
+
+    return count;
+}
+
+/*
+ * Reloads the SysTick for 1 ms ticks after MCLK has changed
+ *  - The count in progress is kept unless it no longer fits the new reload value
+ */
+void G8RTOS_UpdateSysTick()
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t load = (ClockSys_GetSysFreq() / 1000) - 1;
+    SysTick->LOAD = load;
+    if (SysTick->VAL > load)
+    {
+        SysTick->VAL = 0;
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Takes a snapshot of the CPU cycle counters
+ *  - The slice of an idle thread that is running right now is counted as well
+ */
+void G8RTOS_GetIdleCycles(uint32_t *idleCycles, uint32_t *totalCycles)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t now = DWT->CYCCNT;
+    uint32_t idle = IdleCycles;
+
+    if (CurrentlyRunningThread->priority == IDLE_PRIORITY)
+    {
+        idle += now - LastSwitchCycles;
+    }
+
+    EndCriticalSection(IBit_State);
+
+    *idleCycles = idle;
+    *totalCycles = now;
+}
+
 /*********************************************** Public Functions *********************************************************************/
@@ -13,6 +13,8 @@
 #define MAXPTHREADS 6
 #define STACKSIZE 512
 #define OSINT_PRIORITY 7
+#define IDLE_PRIORITY 255
+#define TRACE_LENGTH 64
 /*********************************************** Sizes and Limits *********************************************************************/
 
 /*********************************************** Public Variables *********************************************************************/
@@ -20,6 +22,9 @@
 /* Holds the current time for the whole System */
 extern uint32_t SystemTime;
 
+/* Number of times SystemTime has wrapped, upper 32 bits of the millisecond count */
+extern uint32_t SystemTimeOverflows;
+
 /*********************************************** Public Variables *********************************************************************/
 
 
@@ -62,6 +67,24 @@ sched_ErrCode_t G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t per
 
 sched_ErrCode_t G8RTOS_AddAperiodicEvent(void(*AthreadToAdd)(void), uint8_t priority, IRQn_Type IRQn);
 
+/*
+ * Declares a deadline for a periodic event
+ *  - The time from the release of the event to the end of its handler is measured every period
+ *  - Responses longer than the deadline are counted as misses
+ * Param "PthreadToFind": handler the event was added with
+ * Param "deadlineUs": deadline in us, 0 turns measurement off
+ * Returns: Error code for setting the deadline
+ */
+sched_ErrCode_t G8RTOS_SetPeriodicEventDeadline(void (*PthreadToFind)(void), uint32_t deadlineUs);
+
+/*
+ * Copies the deadline statistics of a periodic event
+ * Param "PthreadToFind": handler the event was added with
+ * Param "stats": Where to store the statistics
+ * Returns: Error code for querying the event
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicEventStats(void (*PthreadToFind)(void), deadline_stats_t *stats);
+
 threadId_t G8RTOS_GetThreadId();
 
 sched_ErrCode_t G8RTOS_KillThread(threadId_t threadId);
@@ -74,8 +97,76 @@ sched_ErrCode_t G8RTOS_KillSelf();
  */
 void sleep(uint32_t durationMS);
 
+/*
+ * Puts the current thread into a sleep state until an absolute time
+ *  - The thread wakes at *lastWake + periodMS, which becomes the new *lastWake
+ *  - Missed releases are skipped and counted in the thread's overruns
+ *  param lastWake: time of the previous release, set to SystemTime once before the loop
+ *  param periodMS: period of the loop in ms, 0 returns at once without sleeping
+ *  Returns: number of releases that were overrun (0 if the loop kept its cadence)
+ */
+uint32_t sleepUntil(uint32_t *lastWake, uint32_t periodMS);
+
 void yield();
 
+/*
+ * Reloads the SysTick for 1 ms ticks after MCLK has changed
+ */
+void G8RTOS_UpdateSysTick();
+
+/*
+ * Takes a snapshot of the CPU cycle counters
+ *  - Idle cycles are cycles spent running threads with IDLE_PRIORITY
+ *  - Both counters wrap, only differences between two snapshots are meaningful
+ *  param idleCycles: where to store the idle cycle count
+ *  param totalCycles: where to store the total cycle count
+ */
+void G8RTOS_GetIdleCycles(uint32_t *idleCycles, uint32_t *totalCycles);
+
+/*
+ * Copies the state of the thread in a tcb slot
+ *  param slot: tcb slot, 0 to MAX_THREADS-1
+ *  param info: where to store the state
+ *  Returns: THREAD_DOES_NOT_EXIST if no live thread uses the slot
+ */
+sched_ErrCode_t G8RTOS_GetThreadInfo(uint32_t slot, thread_info_t *info);
+
+/*
+ * Changes the priority of a thread, it takes effect at the next context switch
+ *  param threadId: thread to change
+ *  param priority: new priority
+ *  Returns: Error code for changing the priority
+ */
+sched_ErrCode_t G8RTOS_SetThreadPriority(threadId_t threadId, uint8_t priority);
+
+/*
+ * Copies the handler and period of the periodic event at an index
+ *  param index: 0 to the number of periodic events - 1
+ *  Returns: EVENT_DOES_NOT_EXIST if there is no event at the index
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicEvent(uint32_t index, void (**handler)(void), uint32_t *period);
+
+/*
+ * Changes the period of the periodic event at an index
+ *  - The next release is one new period from now
+ *  param index: 0 to the number of periodic events - 1
+ *  param period: new period in ms, greater than 0
+ *  Returns: PERIOD_INVALID for a period of 0, or EVENT_DOES_NOT_EXIST if there is no event at the index
+ */
+sched_ErrCode_t G8RTOS_SetPeriodicEventPeriod(uint32_t index, uint32_t period);
+
+/*
+ * Turns the context switch trace on (clearing it) or off
+ */
+void G8RTOS_SetTrace(bool on);
+
+/*
+ * Copies the recorded context switches, oldest first
+ *  param entries: where to store up to TRACE_LENGTH entries
+ *  Returns: number of entries copied
+ */
+uint32_t G8RTOS_GetTrace(trace_entry_t *entries);
+
 /*********************************************** Public Functions *********************************************************************/
 
 #endif /* G8RTOS_SCHEDULER_H_ */
@@ -3,10 +3,13 @@
 ; Note: If you have an h file, do not have a C file and an S file of the same name
 
 	; Functions Defined
-	.def G8RTOS_Start, PendSV_Handler
+	.def G8RTOS_Start, PendSV_Handler, G8RTOS_GetPSP, G8RTOS_SetPSP
 
 	; Dependencies
 	.ref CurrentlyRunningThread, G8RTOS_Scheduler
+	.if $isdefed("G8RTOS_MPU")
+	.ref G8RTOS_SwitchStackRegion
+	.endif
 
 	.thumb		; Set to thumb mode
 	.align 2	; Align by 2 bytes (thumb mode uses allignment by 2 or 4)
@@ -45,6 +48,40 @@ G8RTOS_Start:
 	
 	.endasmfunc
 
+; G8RTOS_GetPSP
+;	Returns the process stack pointer
+G8RTOS_GetPSP:
+
+	.asmfunc
+
+	MRS R0, PSP
+	BX LR
+
+	.endasmfunc
+
+; G8RTOS_SetPSP
+;	Sets the process stack pointer
+; Param R0: new process stack pointer
+G8RTOS_SetPSP:
+
+	.asmfunc
+
+	MSR PSP, R0
+	BX LR
+
+	.endasmfunc
+
+; PendSV_Handler runs from SRAM when built with USE_RAMFUNC (see RamFunc.h)
+; and needs its own copy of the pointer within PC relative reach
+	.if $isdefed("USE_RAMFUNC")
+	.sect ".TI.ramfunc"
+	.else
+	.text
+	.endif
+	.align 4
+
+SwitchRunningPtr: .field CurrentlyRunningThread, 32
+
 ; PendSV_Handler
 ; - Performs a context switch in G8RTOS
 ; 	- Saves remaining registers into thread stack
@@ -62,13 +99,17 @@ PendSV_Handler:
 	MRS R0, PSP			; move process stack pointer into R0
 	STMDB R0!, {R4-R11}	;	push R4 - R11 onto process stack
 	
-	LDR R1, RunningPtr	; get pointer to CurrentlyRunningThread
+	LDR R1, SwitchRunningPtr	; get pointer to CurrentlyRunningThread
 	LDR R1, [R1]		;	de-reference to ThreadControlBlock
 	STR R0, [R1]		;	store R0 in ThreadControlBlock.sp (save stack pointer)
 	
 	BL G8RTOS_Scheduler	; swap in new tcb
+
+	.if $isdefed("G8RTOS_MPU")
+	BL G8RTOS_SwitchStackRegion	; map the new thread's stack read/write
+	.endif
 	
-	LDR R1, RunningPtr	; get pointer to CurrentlyRunningThread
+	LDR R1, SwitchRunningPtr	; get pointer to CurrentlyRunningThread
 	LDR R1, [R1]		;	de-reference to ThreadControlBlock
 	LDR R0, [R1]		;	load process stack pointer from ThreadControlBlock.sp
 	
@@ -8,12 +8,146 @@
 #include "msp.h"
 #include "G8RTOS_Structures.h"
 #include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Static.h"
 
 extern tcb_t * CurrentlyRunningThread;
 
 /*********************************************** Dependencies and Externs *************************************************************/
 
 
+/*********************************************** Defines ******************************************************************************/
+
+/* Timeout of a wait that only ends with a signal */
+#define WAIT_FOREVER 0xFFFFFFFF
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Public Variables *********************************************************************/
+
+#ifdef G8RTOS_STATIC_CONFIG
+
+/* Semaphores listed in G8RTOS_StaticConfig.h */
+#define G8RTOS_STATIC_SEMAPHORE_DEFINITION(nm, value) semaphore_t nm = (value);
+
+G8RTOS_STATIC_SEMAPHORES(G8RTOS_STATIC_SEMAPHORE_DEFINITION)
+
+#endif /* G8RTOS_STATIC_CONFIG */
+
+/*********************************************** Public Variables *********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Wakes the first thread blocked on a semaphore
+ *  - Also cancels the timeout of a timed wait
+ * Must be called inside of a critical section with at least one thread blocked on s
+ */
+static void WakeOne(semaphore_t *s)
+{
+    tcb_t *pt = CurrentlyRunningThread->next;
+    while (pt->blocked != s)
+    {
+        pt = pt->next;
+    }
+
+    pt->blocked = 0;
+    pt->asleep = false;
+}
+
+/*
+ * Blocks the current thread on a semaphore it has already decremented
+ *  - With a timeout the thread also sleeps, if the sleep ends first SysTick undoes the decrement
+ *  - Ends the critical section started by the caller
+ * Returns: true if the thread was woken by a signal, false if it timed out
+ */
+static bool BlockOn(semaphore_t *s, uint32_t timeoutMs, int32_t IBit_State)
+{
+    CurrentlyRunningThread->blocked = s;
+    CurrentlyRunningThread->timedOut = false;
+
+    if (timeoutMs != WAIT_FOREVER)
+    {
+        CurrentlyRunningThread->sleepCount = SystemTime + timeoutMs;
+        CurrentlyRunningThread->asleep = true;
+    }
+
+    EndCriticalSection(IBit_State);
+
+    yield();
+
+    return !CurrentlyRunningThread->timedOut;
+}
+
+/*
+ * Hands a reader-writer lock to every waiting reader
+ * Must be called inside of a critical section while no writer holds the lock
+ */
+static void WakeAllReaders(rwlock_t *rw)
+{
+    while (rw->readQueue < 0)
+    {
+        rw->readers++;
+        G8RTOS_SignalSemaphore(&rw->readQueue);
+    }
+}
+
+/*
+ * Takes a reader-writer lock for reading
+ * Returns: true if the lock was taken, false if the wait timed out
+ */
+static bool ReadLockWait(rwlock_t *rw, uint32_t timeoutMs)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (rw->readers >= 0 && rw->writeQueue == 0)
+    {
+        rw->readers++;
+        EndCriticalSection(IBit_State);
+        return true;
+    }
+
+    if (timeoutMs == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return false;
+    }
+
+    /* the releasing thread counts us as a reader before waking us */
+    rw->readQueue--;
+    return BlockOn(&rw->readQueue, timeoutMs, IBit_State);
+}
+
+/*
+ * Takes a reader-writer lock for writing
+ * Returns: true if the lock was taken, false if the wait timed out
+ */
+static bool WriteLockWait(rwlock_t *rw, uint32_t timeoutMs)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (rw->readers == 0)
+    {
+        rw->readers = -1;
+        EndCriticalSection(IBit_State);
+        return true;
+    }
+
+    if (timeoutMs == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return false;
+    }
+
+    /* the releasing thread leaves the lock marked as written before waking us */
+    rw->writeQueue--;
+    return BlockOn(&rw->writeQueue, timeoutMs, IBit_State);
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
 /*********************************************** Public Functions *********************************************************************/
 
 /*
@@ -48,11 +182,7 @@ void G8RTOS_WaitSemaphore(semaphore_t *s)
 
     if ((*s) < 0)
     {
-        CurrentlyRunningThread->blocked = s;
-
-        EndCriticalSection(IBit);
-
-        yield();
+        BlockOn(s, WAIT_FOREVER, IBit);
     }
     else
     {
@@ -75,16 +205,154 @@ void G8RTOS_SignalSemaphore(semaphore_t *s)
 
     if ((*s) <= 0)
     {
-        tcb_t *pt = CurrentlyRunningThread->next;
-        while (pt->blocked != s)
+        WakeOne(s);
+    }
+
+    EndCriticalSection(IBit);
+}
+
+/*
+ * Takes a semaphore only if that does not block
+ */
+bool G8RTOS_TryWaitSemaphore(semaphore_t *s)
+{
+    return G8RTOS_WaitSemaphoreTimeout(s, 0);
+}
+
+/*
+ * Waits for a semaphore for at most a given time
+ *  - A signal that arrives in the same millisecond as the timeout still wins
+ *    if it is handled before the SysTick
+ */
+bool G8RTOS_WaitSemaphoreTimeout(semaphore_t *s, uint32_t timeoutMs)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if ((*s) > 0)
+    {
+        (*s)--;
+        EndCriticalSection(IBit_State);
+        return true;
+    }
+
+    if (timeoutMs == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return false;
+    }
+
+    (*s)--;
+    return BlockOn(s, timeoutMs, IBit_State);
+}
+
+/*
+ * Initializes a reader-writer lock to unlocked with nobody waiting
+ */
+void G8RTOS_InitRWLock(rwlock_t *rw)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    rw->readers = 0;
+    rw->readQueue = 0;
+    rw->writeQueue = 0;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Takes a reader-writer lock for reading
+ */
+void G8RTOS_ReadLock(rwlock_t *rw)
+{
+    ReadLockWait(rw, WAIT_FOREVER);
+}
+
+/*
+ * Takes a reader-writer lock for reading only if that does not block
+ */
+bool G8RTOS_TryReadLock(rwlock_t *rw)
+{
+    return ReadLockWait(rw, 0);
+}
+
+/*
+ * Takes a reader-writer lock for reading, waiting for at most a given time
+ */
+bool G8RTOS_ReadLockTimeout(rwlock_t *rw, uint32_t timeoutMs)
+{
+    return ReadLockWait(rw, timeoutMs);
+}
+
+/*
+ * Releases a reader-writer lock held for reading
+ *  - The last reader hands the lock to a waiting writer
+ *  - Readers that queued behind a writer whose wait timed out are let in once the lock is free
+ */
+void G8RTOS_ReadUnlock(rwlock_t *rw)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    rw->readers--;
+
+    if (rw->readers == 0)
+    {
+        if (rw->writeQueue < 0)
+        {
+            rw->readers = -1;
+            G8RTOS_SignalSemaphore(&rw->writeQueue);
+        }
+        else
         {
-            pt = pt->next;
+            WakeAllReaders(rw);
         }
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Takes a reader-writer lock for writing
+ */
+void G8RTOS_WriteLock(rwlock_t *rw)
+{
+    WriteLockWait(rw, WAIT_FOREVER);
+}
+
+/*
+ * Takes a reader-writer lock for writing only if that does not block
+ */
+bool G8RTOS_TryWriteLock(rwlock_t *rw)
+{
+    return WriteLockWait(rw, 0);
+}
+
+/*
+ * Takes a reader-writer lock for writing, waiting for at most a given time
+ */
+bool G8RTOS_WriteLockTimeout(rwlock_t *rw, uint32_t timeoutMs)
+{
+    return WriteLockWait(rw, timeoutMs);
+}
 
-        pt->blocked = 0;
+/*
+ * Releases a reader-writer lock held for writing
+ *  - Writer preference: a waiting writer gets the lock before any waiting reader
+ */
+void G8RTOS_WriteUnlock(rwlock_t *rw)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    if (rw->writeQueue < 0)
+    {
+        G8RTOS_SignalSemaphore(&rw->writeQueue);
+    }
+    else
+    {
+        rw->readers = 0;
+        WakeAllReaders(rw);
     }
 
-    EndCriticalSection(IBit);
+    EndCriticalSection(IBit_State);
 }
 
 /*********************************************** Public Functions *********************************************************************/
@@ -5,6 +5,9 @@
 #ifndef G8RTOS_SEMAPHORES_H_
 #define G8RTOS_SEMAPHORES_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
 /*********************************************** Datatype Definitions *****************************************************************/
 
 /*
@@ -12,6 +15,20 @@
  */
 typedef int32_t semaphore_t;
 
+/*
+ * Reader-writer lock
+ *  - Any number of readers or a single writer hold the lock
+ *  - Writer preference: once a writer waits, new readers wait behind it
+ *  - Ownership is handed to the woken threads on release, a woken thread never has to compete for the lock again
+ *  - readers: number of readers holding the lock, -1 while a writer holds it
+ *  - readQueue, writeQueue: semaphores the waiting threads block on, minus their value is the number of waiters
+ */
+typedef struct rwlock_t {
+    int32_t readers;
+    semaphore_t readQueue;
+    semaphore_t writeQueue;
+} rwlock_t;
+
 /*********************************************** Datatype Definitions *****************************************************************/
 
 
@@ -39,6 +56,85 @@ void G8RTOS_WaitSemaphore(semaphore_t *s);
  */
 void G8RTOS_SignalSemaphore(semaphore_t *s);
 
+/*
+ * Takes a semaphore only if that does not block
+ * Param "s": Pointer to semaphore to take
+ * Returns: true if the semaphore was taken
+ */
+bool G8RTOS_TryWaitSemaphore(semaphore_t *s);
+
+/*
+ * Waits for a semaphore for at most a given time
+ * Param "s": Pointer to semaphore to wait on
+ * Param "timeoutMs": Longest time to wait in ms, 0 only tries
+ * Returns: true if the semaphore was taken, false if the wait timed out
+ */
+bool G8RTOS_WaitSemaphoreTimeout(semaphore_t *s, uint32_t timeoutMs);
+
+/*
+ * Initializes a reader-writer lock to unlocked with nobody waiting
+ * Param "rw": Pointer to the lock
+ */
+void G8RTOS_InitRWLock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for reading
+ *  - Waits while a writer holds the lock or is waiting for it
+ * Param "rw": Pointer to the lock
+ */
+void G8RTOS_ReadLock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for reading only if that does not block
+ * Param "rw": Pointer to the lock
+ * Returns: true if the lock was taken
+ */
+bool G8RTOS_TryReadLock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for reading, waiting for at most a given time
+ * Param "rw": Pointer to the lock
+ * Param "timeoutMs": Longest time to wait in ms, 0 only tries
+ * Returns: true if the lock was taken, false if the wait timed out
+ */
+bool G8RTOS_ReadLockTimeout(rwlock_t *rw, uint32_t timeoutMs);
+
+/*
+ * Releases a reader-writer lock held for reading
+ *  - The last reader hands the lock to a waiting writer
+ * Param "rw": Pointer to the lock
+ */
+void G8RTOS_ReadUnlock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for writing
+ *  - Waits while any reader or another writer holds the lock
+ * Param "rw": Pointer to the lock
+ */
+void G8RTOS_WriteLock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for writing only if that does not block
+ * Param "rw": Pointer to the lock
+ * Returns: true if the lock was taken
+ */
+bool G8RTOS_TryWriteLock(rwlock_t *rw);
+
+/*
+ * Takes a reader-writer lock for writing, waiting for at most a given time
+ * Param "rw": Pointer to the lock
+ * Param "timeoutMs": Longest time to wait in ms, 0 only tries
+ * Returns: true if the lock was taken, false if the wait timed out
+ */
+bool G8RTOS_WriteLockTimeout(rwlock_t *rw, uint32_t timeoutMs);
+
+/*
+ * Releases a reader-writer lock held for writing
+ *  - Hands the lock to the next waiting writer, or else to every waiting reader
+ * Param "rw": Pointer to the lock
+ */
+void G8RTOS_WriteUnlock(rwlock_t *rw);
+
 /*********************************************** Public Functions *********************************************************************/
 
 
@@ -0,0 +1,517 @@
+/*
+ * G8RTOS_Shell.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "BSP.h"
+#include "G8RTOS_Shell.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_IPC.h"
+#include "G8RTOS_Static.h"
+#include "G8RTOS_IrqProfile.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Shell command
+ *  - argv[0] is the command name, argc counts it
+ */
+typedef struct shell_command_t {
+    const char *name;
+    void (*handler)(uint32_t argc, char **argv);
+    const char *usage;
+} shell_command_t;
+
+/*
+ * Semaphore shown by the sem command
+ */
+typedef struct shell_semaphore_t {
+    semaphore_t *s;
+    const char *name;
+} shell_semaphore_t;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+#define SHELL_PROMPT "> "
+#define SHELL_MAX_ARGS 4
+#define SHELL_OUTPUT_LENGTH 96
+
+/* Number of received bytes waiting in the back channel buffer */
+static semaphore_t rxBytes;
+
+/* Semaphores shown by the sem command */
+static shell_semaphore_t shellSemaphores[MAX_SHELL_SEMAPHORES];
+static uint32_t numberOfShellSemaphores = 0;
+
+/* Run cycles of every slot and the cycle count at the last ps, CPU% is measured between two ps */
+static threadId_t lastThreadId[MAX_THREADS];
+static uint32_t lastRunCycles[MAX_THREADS];
+static uint32_t lastTotalCycles = 0;
+
+/* Copy of the trace, too large for the shell stack */
+static trace_entry_t traceCopy[TRACE_LENGTH];
+
+/* Output line */
+static char output[SHELL_OUTPUT_LENGTH];
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+static void HelpCommand(uint32_t argc, char **argv);
+static void PsCommand(uint32_t argc, char **argv);
+static void SemCommand(uint32_t argc, char **argv);
+static void FifoCommand(uint32_t argc, char **argv);
+static void PrioCommand(uint32_t argc, char **argv);
+static void PeriodCommand(uint32_t argc, char **argv);
+static void TraceCommand(uint32_t argc, char **argv);
+#ifdef G8RTOS_IRQ_PROFILE
+static void IrqCommand(uint32_t argc, char **argv);
+#endif
+
+static const shell_command_t shellCommands[] = {
+    { "help",   HelpCommand,   "help" },
+    { "ps",     PsCommand,     "ps" },
+    { "sem",    SemCommand,    "sem" },
+    { "fifo",   FifoCommand,   "fifo" },
+    { "prio",   PrioCommand,   "prio <thread> <n>" },
+    { "period", PeriodCommand, "period [<event> <ms>]" },
+    { "trace",  TraceCommand,  "trace on|off" },
+#ifdef G8RTOS_IRQ_PROFILE
+    { "irq",    IrqCommand,    "irq [reset]" },
+#endif
+};
+
+#define NUMBER_OF_SHELL_COMMANDS (sizeof(shellCommands) / sizeof(shellCommands[0]))
+
+static const char *threadStates[] = { "run", "ready", "blocked", "sleep" };
+
+/*
+ * Parses a decimal or 0x prefixed number
+ * Returns: false if the string is not a number
+ */
+static bool ParseNumber(const char *str, uint32_t *value)
+{
+    char *end;
+
+    *value = strtoul(str, &end, 0);
+
+    return (end != str && *end == 0);
+}
+
+/*
+ * Finds the name of the thread with an ID
+ *  - The tcb slot is in the low half of the ID
+ */
+static const char *ThreadName(threadId_t threadId, thread_info_t *info)
+{
+    if (G8RTOS_GetThreadInfo(threadId & 0xFFFF, info) == NO_ERROR && info->threadId == threadId)
+    {
+        return info->threadName;
+    }
+
+    return "?";
+}
+
+/*
+ * Lists the commands
+ */
+static void HelpCommand(uint32_t argc, char **argv)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < NUMBER_OF_SHELL_COMMANDS; i++)
+    {
+        snprintf(output, SHELL_OUTPUT_LENGTH, "%s\r\n", shellCommands[i].usage);
+        BackChannelWrite(output);
+    }
+}
+
+/*
+ * Lists the threads
+ *  - CPU% is the share of cycles since the previous ps, or since launch for the first one
+ */
+static void PsCommand(uint32_t argc, char **argv)
+{
+    thread_info_t info;
+    uint32_t idle = 0;
+    uint32_t total = 0;
+    uint32_t slot = 0;
+
+    G8RTOS_GetIdleCycles(&idle, &total);
+    uint32_t window = total - lastTotalCycles;
+    lastTotalCycles = total;
+
+    BackChannelWrite("slot id       name       prio state   stack cpu%\r\n");
+
+    for (slot = 0; slot < MAX_THREADS; slot++)
+    {
+        if (G8RTOS_GetThreadInfo(slot, &info) != NO_ERROR)
+        {
+            continue;
+        }
+
+        /* A new thread in the slot has no baseline yet */
+        if (lastThreadId[slot] != info.threadId)
+        {
+            lastThreadId[slot] = info.threadId;
+            lastRunCycles[slot] = 0;
+        }
+
+        uint32_t run = info.runCycles - lastRunCycles[slot];
+        lastRunCycles[slot] = info.runCycles;
+
+        uint32_t permille = (window != 0) ? (uint32_t)(((uint64_t)run * 1000) / window) : 0;
+
+        snprintf(output, SHELL_OUTPUT_LENGTH, "%4u %08x %-10s %4u %-7s %5u %3u.%u\r\n",
+                 (unsigned int)slot, (unsigned int)info.threadId, info.threadName, (unsigned int)info.priority,
+                 threadStates[info.state], (unsigned int)info.stackUsed,
+                 (unsigned int)(permille / 10), (unsigned int)(permille % 10));
+        BackChannelWrite(output);
+    }
+}
+
+/*
+ * Lists the registered semaphores
+ *  - A negative value counts the threads blocked on the semaphore
+ */
+static void SemCommand(uint32_t argc, char **argv)
+{
+    uint32_t i = 0;
+
+    BackChannelWrite("name       value waiting\r\n");
+
+    for (i = 0; i < numberOfShellSemaphores; i++)
+    {
+        int32_t value = *shellSemaphores[i].s;
+
+        snprintf(output, SHELL_OUTPUT_LENGTH, "%-10s %5d %7d\r\n",
+                 shellSemaphores[i].name, (int)value, (int)((value < 0) ? -value : 0));
+        BackChannelWrite(output);
+    }
+}
+
+/*
+ * Lists the FIFOs
+ */
+static void FifoCommand(uint32_t argc, char **argv)
+{
+    int32_t size = 0;
+    uint32_t lostData = 0;
+    uint32_t i = 0;
+
+    BackChannelWrite("fifo size lost\r\n");
+
+    while (G8RTOS_GetFIFOStats(i, &size, &lostData) == 0)
+    {
+        snprintf(output, SHELL_OUTPUT_LENGTH, "%4u %4d %4u\r\n", (unsigned int)i, (int)size, (unsigned int)lostData);
+        BackChannelWrite(output);
+        i++;
+    }
+}
+
+/*
+ * Changes the priority of a thread given by name or tcb slot
+ */
+static void PrioCommand(uint32_t argc, char **argv)
+{
+    thread_info_t info;
+    uint32_t priority = 0;
+    uint32_t slot = 0;
+
+    if (argc != 3 || !ParseNumber(argv[2], &priority) || priority > IDLE_PRIORITY)
+    {
+        BackChannelWrite("usage: prio <thread> <0-255>\r\n");
+        return;
+    }
+
+    for (slot = 0; slot < MAX_THREADS; slot++)
+    {
+        if (G8RTOS_GetThreadInfo(slot, &info) == NO_ERROR && strcmp(info.threadName, argv[1]) == 0)
+        {
+            break;
+        }
+    }
+
+    if (slot == MAX_THREADS)
+    {
+        if (!ParseNumber(argv[1], &slot) || G8RTOS_GetThreadInfo(slot, &info) != NO_ERROR)
+        {
+            BackChannelWrite("no such thread\r\n");
+            return;
+        }
+    }
+
+    if (G8RTOS_SetThreadPriority(info.threadId, (uint8_t)priority) != NO_ERROR)
+    {
+        BackChannelWrite("no such thread\r\n");
+    }
+}
+
+/*
+ * Lists the periodic events, or changes the period of one
+ */
+static void PeriodCommand(uint32_t argc, char **argv)
+{
+    void (*handler)(void);
+    uint32_t period = 0;
+    uint32_t index = 0;
+
+    if (argc == 1)
+    {
+        BackChannelWrite("event handler  period\r\n");
+
+        while (G8RTOS_GetPeriodicEvent(index, &handler, &period) == NO_ERROR)
+        {
+            snprintf(output, SHELL_OUTPUT_LENGTH, "%5u %08x %6u\r\n",
+                     (unsigned int)index, (unsigned int)handler, (unsigned int)period);
+            BackChannelWrite(output);
+            index++;
+        }
+        return;
+    }
+
+    if (argc != 3 || !ParseNumber(argv[1], &index) || !ParseNumber(argv[2], &period) || period == 0)
+    {
+        BackChannelWrite("usage: period [<event> <ms>]\r\n");
+        return;
+    }
+
+    if (G8RTOS_SetPeriodicEventPeriod(index, period) != NO_ERROR)
+    {
+        BackChannelWrite("no such event\r\n");
+    }
+}
+
+/*
+ * Starts recording context switches, or stops and prints them
+ *  - Cycles are relative to the first switch printed
+ */
+static void TraceCommand(uint32_t argc, char **argv)
+{
+    thread_info_t fromInfo;
+    thread_info_t toInfo;
+    uint32_t i = 0;
+
+    if (argc == 2 && strcmp(argv[1], "on") == 0)
+    {
+        G8RTOS_SetTrace(true);
+        return;
+    }
+
+    if (argc != 2 || strcmp(argv[1], "off") != 0)
+    {
+        BackChannelWrite("usage: trace on|off\r\n");
+        return;
+    }
+
+    G8RTOS_SetTrace(false);
+
+    uint32_t count = G8RTOS_GetTrace(traceCopy);
+
+    for (i = 0; i < count; i++)
+    {
+        snprintf(output, SHELL_OUTPUT_LENGTH, "%10u %-10s -> %s\r\n",
+                 (unsigned int)(traceCopy[i].cycles - traceCopy[0].cycles),
+                 ThreadName(traceCopy[i].from, &fromInfo), ThreadName(traceCopy[i].to, &toInfo));
+        BackChannelWrite(output);
+    }
+}
+
+#ifdef G8RTOS_IRQ_PROFILE
+/*
+ * Prints the interrupt histograms, or clears them
+ */
+static void IrqCommand(uint32_t argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[1], "reset") == 0)
+    {
+        G8RTOS_ResetIrqStats();
+        return;
+    }
+
+    G8RTOS_DumpIrqStats();
+}
+#endif
+
+/*
+ * Splits a line at spaces and runs the command
+ */
+static void RunLine(char *line)
+{
+    char *argv[SHELL_MAX_ARGS];
+    uint32_t argc = 0;
+    uint32_t i = 0;
+
+    while (*line != 0 && argc < SHELL_MAX_ARGS)
+    {
+        while (*line == ' ')
+        {
+            *line++ = 0;
+        }
+
+        if (*line == 0)
+        {
+            break;
+        }
+
+        argv[argc++] = line;
+
+        while (*line != ' ' && *line != 0)
+        {
+            line++;
+        }
+    }
+
+    if (argc == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < NUMBER_OF_SHELL_COMMANDS; i++)
+    {
+        if (strcmp(argv[0], shellCommands[i].name) == 0)
+        {
+            shellCommands[i].handler(argc, argv);
+            return;
+        }
+    }
+
+    BackChannelWrite("unknown command, try help\r\n");
+}
+
+/*
+ * Receive interrupt
+ *  - Only moves the byte into the back channel buffer and wakes the shell thread
+ */
+static void ShellRxISR()
+{
+    if (BackChannelRxISR())
+    {
+        G8RTOS_SignalSemaphore(&rxBytes);
+    }
+}
+
+/*
+ * Shell thread
+ *  - Echoes input, handles backspace and runs a line on CR or LF, a CR LF pair ends only one line
+ */
+static void ShellThread()
+{
+    char line[SHELL_LINE_LENGTH];
+    char echo[2] = { 0, 0 };
+    uint32_t length = 0;
+    int32_t last = 0;
+
+    BackChannelWrite(SHELL_PROMPT);
+
+    while(1)
+    {
+        G8RTOS_WaitSemaphore(&rxBytes);
+
+        int32_t c = BackChannelGetChar();
+
+        if (c < 0)
+        {
+            continue;
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            if (!(c == '\n' && last == '\r'))
+            {
+                BackChannelWrite("\r\n");
+                line[length] = 0;
+                RunLine(line);
+                length = 0;
+                BackChannelWrite(SHELL_PROMPT);
+            }
+        }
+        else if (c == '\b' || c == 0x7F)
+        {
+            if (length > 0)
+            {
+                length--;
+                BackChannelWrite("\b \b");
+            }
+        }
+        else if (c >= ' ' && length < SHELL_LINE_LENGTH - 1)
+        {
+            line[length++] = (char)c;
+            echo[0] = (char)c;
+            BackChannelWrite(echo);
+        }
+
+        last = c;
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the shell
+ */
+sched_ErrCode_t G8RTOS_StartShell(uint8_t priority)
+{
+    sched_ErrCode_t error;
+
+#ifdef G8RTOS_STATIC_CONFIG
+#define G8RTOS_SHELL_REGISTER_SEMAPHORE(nm, value) G8RTOS_ShellRegisterSemaphore(&nm, #nm);
+    G8RTOS_STATIC_SEMAPHORES(G8RTOS_SHELL_REGISTER_SEMAPHORE)
+#undef G8RTOS_SHELL_REGISTER_SEMAPHORE
+#endif
+
+    G8RTOS_InitSemaphore(&rxBytes, 0);
+
+    error = G8RTOS_AddThread(ShellThread, priority, "shell");
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+
+    error = G8RTOS_AddAperiodicEvent(ShellRxISR, SHELL_RX_PRIORITY, EUSCIA0_IRQn);
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+
+    BackChannelEnableRx();
+
+    return NO_ERROR;
+}
+
+/*
+ * Makes a semaphore visible to the sem command
+ */
+sched_ErrCode_t G8RTOS_ShellRegisterSemaphore(semaphore_t *s, const char *name)
+{
+    if (numberOfShellSemaphores >= MAX_SHELL_SEMAPHORES)
+    {
+        return REGISTRY_FULL;
+    }
+
+    shellSemaphores[numberOfShellSemaphores].s = s;
+    shellSemaphores[numberOfShellSemaphores].name = name;
+    numberOfShellSemaphores++;
+
+    return NO_ERROR;
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,58 @@
+/*
+ * G8RTOS_Shell.h
+ *
+ * Command shell on the back channel UART (115200 8N1)
+ *  - Received bytes are collected by the EUSCIA0 interrupt, a low priority thread runs the commands
+ *  - help                   lists the commands
+ *  - ps                     threads with state, priority, stack high water mark and CPU% since the last ps
+ *  - sem                    registered semaphores with their value and number of waiting threads
+ *  - fifo                   fill level and lost data of every FIFO
+ *  - prio <thread> <n>      changes the priority of a thread (by name or tcb slot)
+ *  - period                 lists the periodic events
+ *  - period <event> <ms>    changes the period of a periodic event (by index)
+ *  - trace on|off           records context switches, off prints them
+ *  - irq [reset]            interrupt duration and latency histograms, with G8RTOS_IRQ_PROFILE
+ */
+
+#ifndef G8RTOS_SHELL_H_
+#define G8RTOS_SHELL_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Longest command line */
+#define SHELL_LINE_LENGTH 64
+
+/* Maximum number of semaphores the sem command can show */
+#define MAX_SHELL_SEMAPHORES 8
+
+/* Priority of the receive interrupt */
+#define SHELL_RX_PRIORITY 6
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the shell
+ *  - Installs the receive interrupt on EUSCIA0_IRQn and adds the shell thread
+ *  - With G8RTOS_STATIC_CONFIG the static semaphores are registered by name
+ * Param "priority": Priority of the shell thread, should be low
+ * Returns: Error code for adding the thread or the interrupt
+ */
+sched_ErrCode_t G8RTOS_StartShell(uint8_t priority);
+
+/*
+ * Makes a semaphore visible to the sem command
+ * Param "s": Semaphore to show
+ * Param "name": Name to show it under, must stay valid
+ * Returns: REGISTRY_FULL if MAX_SHELL_SEMAPHORES are already registered
+ */
+sched_ErrCode_t G8RTOS_ShellRegisterSemaphore(semaphore_t *s, const char *name);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_SHELL_H_ */
@@ -0,0 +1,88 @@
+/*
+ * G8RTOS_Static.h
+ *
+ * Compile-time declaration of threads, periodic events, semaphores and FIFOs
+ *  - Enabled by building with G8RTOS_STATIC_CONFIG defined, the objects are listed in G8RTOS_StaticConfig.h
+ *  - The TCB ring, the initial stack frames, the periodic event list, semaphore values and FIFO pointers
+ *    are emitted as initialized data, so G8RTOS_Init and G8RTOS_Launch do not build any lists
+ *  - Too many objects, priorities above IDLE_PRIORITY, names that do not fit a tcb and zero periods fail the build
+ *  - Threads and events can still be added at runtime on top of the static ones
+ */
+
+#ifndef G8RTOS_STATIC_H_
+#define G8RTOS_STATIC_H_
+
+#include <stdint.h>
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_Scheduler.h"
+
+#ifdef G8RTOS_STATIC_CONFIG
+
+#include "G8RTOS_StaticConfig.h"
+
+/*********************************************** Compile Time Checks ******************************************************************/
+
+/*
+ * Fails the build with a negative array size when a condition does not hold
+ */
+#define G8RTOS_STATIC_ASSERT(condition, name) typedef char G8RTOS_StaticAssert_##name[(condition) ? 1 : -1]
+
+/*********************************************** Compile Time Checks ******************************************************************/
+
+
+/*********************************************** Generated Declarations ***************************************************************/
+
+/* Handlers of threads and events */
+#define G8RTOS_STATIC_THREAD_PROTOTYPE(fn, prio, nm) extern void fn(void);
+#define G8RTOS_STATIC_EVENT_PROTOTYPE(fn, per) extern void fn(void);
+
+G8RTOS_STATIC_THREADS(G8RTOS_STATIC_THREAD_PROTOTYPE)
+G8RTOS_STATIC_PERIODIC_EVENTS(G8RTOS_STATIC_EVENT_PROTOTYPE)
+
+/* Slot of every thread and event in the order they are listed, followed by their count */
+#define G8RTOS_STATIC_THREAD_SLOT(fn, prio, nm) G8RTOS_THREAD_SLOT_##fn,
+#define G8RTOS_STATIC_EVENT_SLOT(fn, per) G8RTOS_EVENT_SLOT_##fn,
+
+enum { G8RTOS_STATIC_THREADS(G8RTOS_STATIC_THREAD_SLOT) G8RTOS_STATIC_THREAD_COUNT };
+enum { G8RTOS_STATIC_PERIODIC_EVENTS(G8RTOS_STATIC_EVENT_SLOT) G8RTOS_STATIC_EVENT_COUNT };
+
+/* FIFO numbers for readFIFO and writeFIFO */
+#define G8RTOS_STATIC_FIFO_INDEX(index) index,
+
+enum { G8RTOS_STATIC_FIFOS(G8RTOS_STATIC_FIFO_INDEX) G8RTOS_STATIC_FIFO_COUNT };
+
+/* Semaphores, defined in G8RTOS_Semaphores.c */
+#define G8RTOS_STATIC_SEMAPHORE_DECLARATION(nm, value) extern semaphore_t nm;
+
+G8RTOS_STATIC_SEMAPHORES(G8RTOS_STATIC_SEMAPHORE_DECLARATION)
+
+/*********************************************** Generated Declarations ***************************************************************/
+
+
+/*********************************************** Compile Time Checks ******************************************************************/
+
+G8RTOS_STATIC_ASSERT(G8RTOS_STATIC_THREAD_COUNT > 0, at_least_one_static_thread);
+G8RTOS_STATIC_ASSERT(G8RTOS_STATIC_THREAD_COUNT <= MAX_THREADS, too_many_static_threads);
+G8RTOS_STATIC_ASSERT(G8RTOS_STATIC_EVENT_COUNT <= MAXPTHREADS, too_many_static_events);
+
+#define G8RTOS_STATIC_THREAD_CHECKS(fn, prio, nm) \
+    G8RTOS_STATIC_ASSERT((prio) >= 0 && (prio) <= IDLE_PRIORITY, priority_of_##fn); \
+    G8RTOS_STATIC_ASSERT(sizeof(nm) <= MAX_NAME_LENGTH, name_of_##fn);
+
+#define G8RTOS_STATIC_EVENT_CHECKS(fn, per) \
+    G8RTOS_STATIC_ASSERT((per) > 0, period_of_##fn);
+
+G8RTOS_STATIC_THREADS(G8RTOS_STATIC_THREAD_CHECKS)
+G8RTOS_STATIC_PERIODIC_EVENTS(G8RTOS_STATIC_EVENT_CHECKS)
+
+/*********************************************** Compile Time Checks ******************************************************************/
+
+#else
+
+/* Nothing is declared statically, everything is added at runtime */
+#define G8RTOS_STATIC_THREAD_COUNT 0
+#define G8RTOS_STATIC_EVENT_COUNT 0
+
+#endif /* G8RTOS_STATIC_CONFIG */
+
+#endif /* G8RTOS_STATIC_H_ */
@@ -0,0 +1,39 @@
+/*
+ * G8RTOS_StaticConfig.h
+ *
+ * Threads, periodic events, semaphores and FIFOs that exist from boot
+ *  - Only used when the project is built with G8RTOS_STATIC_CONFIG defined
+ *  - Each list calls its macro argument once per object, objects are separated by a backslash:
+ *
+ *      #define G8RTOS_STATIC_THREADS(THREAD) \
+ *          THREAD(IdleThread, IDLE_PRIORITY, "idle") \
+ *          THREAD(DrawObjects, 2, "draw")
+ *
+ *      #define G8RTOS_STATIC_PERIODIC_EVENTS(EVENT) \
+ *          EVENT(ReadJoystick, 5)
+ *
+ *      #define G8RTOS_STATIC_SEMAPHORES(SEMAPHORE) \
+ *          SEMAPHORE(LCDMutex, 1)
+ *
+ *      #define G8RTOS_STATIC_FIFOS(FIFO) \
+ *          FIFO(JOYSTICK_FIFO)
+ *
+ *  - THREAD(handler, priority, name): handler must be an extern void-void function,
+ *    name a string literal of at most MAX_NAME_LENGTH - 1 characters
+ *  - EVENT(handler, period): period in ms, greater than 0
+ *  - SEMAPHORE(name, value): defines a semaphore_t called name with an initial value
+ *  - FIFO(index): defines index as the FIFO number to pass to readFIFO/writeFIFO
+ */
+
+#ifndef G8RTOS_STATICCONFIG_H_
+#define G8RTOS_STATICCONFIG_H_
+
+#define G8RTOS_STATIC_THREADS(THREAD)
+
+#define G8RTOS_STATIC_PERIODIC_EVENTS(EVENT)
+
+#define G8RTOS_STATIC_SEMAPHORES(SEMAPHORE)
+
+#define G8RTOS_STATIC_FIFOS(FIFO)
+
+#endif /* G8RTOS_STATICCONFIG_H_ */
@@ -23,7 +23,14 @@ typedef enum {
     THREAD_DOES_NOT_EXIST = -4,
     CANNOT_KILL_LAST_THREAD = -5,
     IRQn_INVALID = -6,
-    HWI_PRIORITY_INVALID = -7
+    HWI_PRIORITY_INVALID = -7,
+    EVENT_DOES_NOT_EXIST = -8,
+    SUPERVISOR_LIMIT_REACHED = -9,
+    REGISTRY_FULL = -10,
+    PIN_INVALID = -11,
+    BUDGET_INVALID = -12,
+    QUEUE_FULL = -13,
+    PERIOD_INVALID = -14
 } sched_ErrCode_t;
 
 typedef uint32_t threadId_t;
@@ -42,18 +49,71 @@ typedef struct tcb_t {
     struct tcb_t * prev;
     semaphore_t * blocked;
     uint32_t sleepCount;
+    uint32_t overruns;
     bool asleep;
+    bool timedOut;
     bool isAlive;
     uint8_t priority;
     char threadName[MAX_NAME_LENGTH];
     threadId_t threadId;
+    uint32_t runCycles;
 } tcb_t;
 
+/*
+ *  Thread Information:
+ *      - Copy of the state of a thread for introspection (e.g. the shell's ps)
+ *      - stackUsed is the high water mark of the stack in bytes
+ *      - runCycles counts the CPU cycles the thread has run, interrupts included; it wraps
+ */
+typedef enum {
+    THREAD_RUNNING = 0,
+    THREAD_READY,
+    THREAD_BLOCKED,
+    THREAD_SLEEPING
+} thread_state_t;
+
+typedef struct thread_info_t {
+    threadId_t threadId;
+    char threadName[MAX_NAME_LENGTH];
+    uint8_t priority;
+    thread_state_t state;
+    uint32_t stackUsed;
+    uint32_t runCycles;
+} thread_info_t;
+
+/*
+ *  Context Switch Trace Entry:
+ *      - Recorded by the scheduler while tracing is on
+ *      - cycles is the DWT cycle count at the switch
+ */
+typedef struct trace_entry_t {
+    uint32_t cycles;
+    threadId_t from;
+    threadId_t to;
+} trace_entry_t;
+
+/*
+ *  Deadline Statistics:
+ *      - Kept for every periodic event and supervised thread that declares a deadline
+ *      - Histogram bucket 0 counts response times of 0 us, bucket n counts [2^(n-1), 2^n) us,
+ *        the last bucket also counts everything above its range
+ */
+#define DEADLINE_HISTOGRAM_BUCKETS 16
+
+typedef struct deadline_stats_t {
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t worstResponse;
+    uint32_t worstLateness;
+    uint32_t histogram[DEADLINE_HISTOGRAM_BUCKETS];
+} deadline_stats_t;
+
 /*
  *  Periodic Thread Control Block:
  *      - Holds a function pointer that points to the periodic thread to be executed
  *      - Has a period in us
  *      - Holds Current time
+ *      - Holds a deadline in us (0 if none) and the deadline statistics of the event
  *      - Contains pointer to the next periodic event - linked list
  */
 
@@ -63,6 +123,8 @@ typedef struct ptcb_t {
     uint32_t period;
     uint32_t execute_time;
     uint32_t current_time;
+    uint32_t deadline;
+    deadline_stats_t stats;
     struct ptcb_t * prev;
     struct ptcb_t * next;
 } ptcb_t;
@@ -0,0 +1,332 @@
+/*
+ * G8RTOS_Supervisor.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "G8RTOS_Supervisor.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_CriticalSection.h"
+
+extern tcb_t * CurrentlyRunningThread;
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/*
+ * Supervised thread
+ *  - threadId is kept next to the tcb so a killed thread whose tcb got reused is detected
+ *  - silent is set once a missing heartbeat has been counted as a miss, so it is only counted once
+ */
+typedef struct supervised_t {
+    tcb_t * tcb;
+    threadId_t threadId;
+    uint32_t period;
+    uint32_t deadline;
+    uint32_t lastBeatMs;
+    uint64_t lastBeatUs;
+    bool alive;
+    bool silent;
+    deadline_stats_t stats;
+} supervised_t;
+
+/* Supervised threads */
+static supervised_t supervisedThreads[MAX_SUPERVISED_THREADS];
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/* Number of entries in supervisedThreads */
+static uint32_t NumberOfSupervised;
+
+/* Milliseconds until the next heartbeat check */
+static uint32_t checkCountdown = SUPERVISOR_CHECK_PERIOD;
+
+/* Result of the last heartbeat check */
+static bool allAlive = true;
+
+/* Set once WDT_A has been started */
+static bool watchdogRunning = false;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Log2 histogram bucket of a value in us
+ */
+static uint32_t HistogramBucket(uint32_t value)
+{
+    uint32_t bucket = 0;
+
+    while (value != 0 && bucket < DEADLINE_HISTOGRAM_BUCKETS - 1)
+    {
+        value >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/*
+ * Finds the supervisor entry of a thread
+ * Returns: index of the entry, or -1 if the thread is not supervised
+ * Must be called inside of a critical section
+ */
+static int32_t FindSupervised(threadId_t threadId)
+{
+    int32_t i = 0;
+
+    for (i = 0; i < NumberOfSupervised; i++)
+    {
+        if (supervisedThreads[i].threadId == threadId)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Removes an entry by moving the last entry into its place
+ * Must be called inside of a critical section
+ */
+static void RemoveSupervised(int32_t index)
+{
+    NumberOfSupervised--;
+    supervisedThreads[index] = supervisedThreads[NumberOfSupervised];
+}
+
+/*
+ * Restarts the WDT_A count without touching its configuration
+ */
+static inline void KickWatchdog()
+{
+    WDT_A->CTL = WDT_A_CTL_PW | (WDT_A->CTL & 0x00FF) | WDT_A_CTL_CNTCL;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Registers the calling thread with the supervisor
+ */
+sched_ErrCode_t G8RTOS_SupervisorRegisterThread(uint32_t periodMs, uint32_t deadlineMs)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    int32_t i = FindSupervised(CurrentlyRunningThread->threadId);
+
+    if (i < 0)
+    {
+        if (NumberOfSupervised >= MAX_SUPERVISED_THREADS)
+        {
+            EndCriticalSection(IBit_State);
+            return SUPERVISOR_LIMIT_REACHED;
+        }
+        i = NumberOfSupervised++;
+    }
+
+    supervised_t * entry = &supervisedThreads[i];
+    entry->tcb = CurrentlyRunningThread;
+    entry->threadId = CurrentlyRunningThread->threadId;
+    entry->period = periodMs;
+    entry->deadline = (deadlineMs < periodMs) ? periodMs : deadlineMs;
+    entry->lastBeatMs = SystemTime;
+    entry->lastBeatUs = G8RTOS_GetTimeUs();
+    entry->alive = true;
+    entry->silent = false;
+    memset(&entry->stats, 0, sizeof(deadline_stats_t));
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Removes the calling thread from the supervisor
+ */
+void G8RTOS_SupervisorUnregisterThread()
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    int32_t i = FindSupervised(CurrentlyRunningThread->threadId);
+    if (i >= 0)
+    {
+        RemoveSupervised(i);
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Checks the calling thread in with the supervisor
+ *  - The time since the previous heartbeat is the response time of this iteration
+ */
+void G8RTOS_Heartbeat()
+{
+    uint64_t now = G8RTOS_GetTimeUs();
+
+    int32_t IBit_State = StartCriticalSection();
+
+    int32_t i = FindSupervised(CurrentlyRunningThread->threadId);
+    if (i >= 0)
+    {
+        supervised_t * entry = &supervisedThreads[i];
+        uint64_t interval = now - entry->lastBeatUs;
+
+        if (interval > 0xFFFFFFFF)
+        {
+            interval = 0xFFFFFFFF;
+        }
+
+        /* a silence already counted by the check is not counted a second time */
+        if (entry->silent)
+        {
+            entry->stats.misses--;
+        }
+
+        G8RTOS_RecordDeadline(&entry->stats, (uint32_t)interval, entry->period * 1000, entry->deadline * 1000);
+
+        entry->lastBeatMs = SystemTime;
+        entry->lastBeatUs = now;
+        entry->alive = true;
+        entry->silent = false;
+    }
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Starts WDT_A (ACLK, 2^15 cycles = 1 s)
+ */
+void G8RTOS_SupervisorStartWatchdog()
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    WDT_A->CTL = WDT_A_CTL_PW | WDT_A_CTL_SSEL__ACLK | WDT_A_CTL_CNTCL | WDT_A_CTL_IS_4;
+    watchdogRunning = true;
+
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Returns whether every registered thread checked in within its hang limit at the last check
+ */
+bool G8RTOS_SupervisorAllAlive()
+{
+    return allAlive;
+}
+
+/*
+ * Copies the deadline statistics of a supervised thread
+ */
+sched_ErrCode_t G8RTOS_GetThreadDeadlineStats(threadId_t threadId, deadline_stats_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    int32_t i = FindSupervised(threadId);
+    if (i < 0)
+    {
+        EndCriticalSection(IBit_State);
+        return THREAD_DOES_NOT_EXIST;
+    }
+
+    *stats = supervisedThreads[i].stats;
+
+    EndCriticalSection(IBit_State);
+
+    return NO_ERROR;
+}
+
+/*
+ * Adds one response time to a set of deadline statistics
+ */
+void G8RTOS_RecordDeadline(deadline_stats_t *stats, uint32_t responseUs, uint32_t nominalUs, uint32_t deadlineUs)
+{
+    uint32_t lateness = (responseUs > nominalUs) ? (responseUs - nominalUs) : 0;
+
+    stats->runs++;
+    stats->histogram[HistogramBucket(lateness)]++;
+
+    if (responseUs > stats->worstResponse)
+    {
+        stats->worstResponse = responseUs;
+    }
+
+    if (lateness > stats->worstLateness)
+    {
+        stats->worstLateness = lateness;
+    }
+
+    if (responseUs > deadlineUs)
+    {
+        stats->misses++;
+    }
+}
+
+/*
+ * Called from SysTick_Handler every millisecond
+ *  - Drops entries of threads that have been killed
+ *  - A thread silent past its deadline counts a miss, past its hang limit it is no longer alive
+ *  - Kicks the watchdog only if every thread is alive
+ */
+void G8RTOS_SupervisorTick()
+{
+    if (--checkCountdown != 0)
+    {
+        return;
+    }
+    checkCountdown = SUPERVISOR_CHECK_PERIOD;
+
+    bool everyoneAlive = true;
+    int32_t i = 0;
+
+    while (i < NumberOfSupervised)
+    {
+        supervised_t * entry = &supervisedThreads[i];
+
+        if (!entry->tcb->isAlive || entry->tcb->threadId != entry->threadId)
+        {
+            RemoveSupervised(i);
+            continue;
+        }
+
+        uint32_t silence = SystemTime - entry->lastBeatMs;
+
+        if (silence > entry->deadline && !entry->silent)
+        {
+            entry->stats.misses++;
+            entry->silent = true;
+        }
+
+        if (silence > entry->deadline * SUPERVISOR_HANG_FACTOR)
+        {
+            entry->alive = false;
+        }
+
+        everyoneAlive = everyoneAlive && entry->alive;
+        i++;
+    }
+
+    allAlive = everyoneAlive;
+
+    if (watchdogRunning && allAlive)
+    {
+        KickWatchdog();
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,93 @@
+/*
+ * G8RTOS_Supervisor.h
+ *
+ * Deadline monitor and health supervisor
+ *  - Periodic events declare a deadline with G8RTOS_SetPeriodicEventDeadline (G8RTOS_Scheduler.h)
+ *  - Threads register with a period and a deadline and check in once per iteration with G8RTOS_Heartbeat
+ *  - Every SUPERVISOR_CHECK_PERIOD ms the supervisor checks that no registered thread has gone silent
+ *  - Once the watchdog is started, WDT_A is only kicked while every registered thread is alive
+ */
+
+#ifndef G8RTOS_SUPERVISOR_H_
+#define G8RTOS_SUPERVISOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+/* Maximum number of threads that can be supervised */
+#define MAX_SUPERVISED_THREADS 8
+
+/* How often (in ms) the supervisor checks heartbeats and kicks the watchdog */
+#define SUPERVISOR_CHECK_PERIOD 50
+
+/* A thread that has not checked in for this many deadlines is considered hung */
+#define SUPERVISOR_HANG_FACTOR 4
+
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Registers the calling thread with the supervisor
+ *  - The thread is expected to call G8RTOS_Heartbeat every periodMs
+ *  - An interval between heartbeats longer than deadlineMs is counted as a deadline miss
+ *  - A thread that is silent for SUPERVISOR_HANG_FACTOR * deadlineMs is considered hung
+ * Param "periodMs": Expected time between heartbeats
+ * Param "deadlineMs": Longest acceptable time between heartbeats (>= periodMs)
+ * Returns: Error code for registering the thread
+ */
+sched_ErrCode_t G8RTOS_SupervisorRegisterThread(uint32_t periodMs, uint32_t deadlineMs);
+
+/*
+ * Removes the calling thread from the supervisor (e.g. before it blocks indefinitely)
+ */
+void G8RTOS_SupervisorUnregisterThread();
+
+/*
+ * Checks the calling thread in with the supervisor and records its lateness
+ */
+void G8RTOS_Heartbeat();
+
+/*
+ * Starts WDT_A (ACLK, 2^15 cycles = 1 s)
+ *  - From here on the watchdog is only kicked while every registered thread is alive
+ */
+void G8RTOS_SupervisorStartWatchdog();
+
+/*
+ * Returns whether every registered thread checked in within its hang limit at the last check
+ */
+bool G8RTOS_SupervisorAllAlive();
+
+/*
+ * Copies the deadline statistics of a supervised thread
+ * Param "threadId": Thread to query
+ * Param "stats": Where to store the statistics
+ * Returns: Error code for querying the thread
+ */
+sched_ErrCode_t G8RTOS_GetThreadDeadlineStats(threadId_t threadId, deadline_stats_t *stats);
+
+/*
+ * Adds one response time to a set of deadline statistics
+ *  - Lateness (response past its nominal time) goes into the histogram
+ *  - A response longer than the deadline is counted as a miss
+ * Param "stats": Statistics to update
+ * Param "responseUs": Measured time (event: release to completion, thread: heartbeat interval)
+ * Param "nominalUs": Response expected when nothing is late (event: 0, thread: its period)
+ * Param "deadlineUs": Deadline the response is measured against
+ */
+void G8RTOS_RecordDeadline(deadline_stats_t *stats, uint32_t responseUs, uint32_t nominalUs, uint32_t deadlineUs);
+
+/*
+ * Called from SysTick_Handler every millisecond
+ *  - Runs the heartbeat check every SUPERVISOR_CHECK_PERIOD ms
+ */
+void G8RTOS_SupervisorTick();
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_SUPERVISOR_H_ */
@@ -0,0 +1,83 @@
+/*
+ * G8RTOS_Time.c
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "msp.h"
+#include "G8RTOS_Time.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Returns the time since G8RTOS_Launch in microseconds
+ *  - SystemTime counts whole milliseconds, SysTick counts down the cycles of the current one
+ *  - If the SysTick has reloaded but its handler has not run yet (interrupts masked or we are in a
+ *    higher priority ISR), the millisecond has already passed and is added here
+ */
+uint64_t G8RTOS_GetTimeUs()
+{
+    int32_t IBit_State = StartCriticalSection();
+
+    uint32_t low = SystemTime;
+    uint32_t high = SystemTimeOverflows;
+    uint32_t cyclesPerMs = SysTick->LOAD + 1;
+    uint32_t elapsedCycles = SysTick->LOAD - SysTick->VAL;
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        /* counter reloaded, re-read so the cycle count belongs to the new millisecond */
+        elapsedCycles = SysTick->LOAD - SysTick->VAL;
+        low++;
+        if (low == 0)
+        {
+            high++;
+        }
+    }
+
+    EndCriticalSection(IBit_State);
+
+    uint64_t ms = (((uint64_t)high) << 32) | low;
+
+    return (ms * 1000) + (((uint64_t)elapsedCycles * 1000) / cyclesPerMs);
+}
+
+/*
+ * Returns the number of microseconds elapsed since a time from G8RTOS_GetTimeUs
+ */
+uint64_t G8RTOS_ElapsedUs(uint64_t startUs)
+{
+    return G8RTOS_GetTimeUs() - startUs;
+}
+
+/*
+ * Returns whether a microsecond deadline from G8RTOS_GetTimeUs has been reached
+ */
+bool G8RTOS_DeadlineReachedUs(uint64_t deadlineUs)
+{
+    return (G8RTOS_GetTimeUs() >= deadlineUs);
+}
+
+/*
+ * Returns whether a millisecond deadline (in SystemTime units) has been reached
+ */
+bool G8RTOS_DeadlineReached(uint32_t deadlineMs)
+{
+    return G8RTOS_TimeAfterEq(SystemTime, deadlineMs);
+}
+
+/*
+ * Returns the number of milliseconds elapsed since a SystemTime value
+ */
+uint32_t G8RTOS_ElapsedMs(uint32_t startMs)
+{
+    return (SystemTime - startMs);
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,69 @@
+/*
+ * G8RTOS_Time.h
+ *
+ * Monotonic time base
+ *  - 64-bit microsecond clock built from SystemTime, its overflow count and the current SysTick count
+ *  - Wrap-safe comparison helpers for the 32-bit millisecond SystemTime
+ */
+
+#ifndef G8RTOS_TIME_H_
+#define G8RTOS_TIME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Returns the time since G8RTOS_Launch in microseconds
+ *  - Resolution is one microsecond (interpolated from the SysTick down counter)
+ *  - Monotonic, does not wrap for the lifetime of the device
+ *  - Safe to call from threads and ISRs
+ */
+uint64_t G8RTOS_GetTimeUs();
+
+/*
+ * Returns the number of microseconds elapsed since a time from G8RTOS_GetTimeUs
+ * Param "startUs": Start of the measured interval
+ */
+uint64_t G8RTOS_ElapsedUs(uint64_t startUs);
+
+/*
+ * Returns whether a microsecond deadline from G8RTOS_GetTimeUs has been reached
+ * Param "deadlineUs": Absolute deadline in microseconds
+ */
+bool G8RTOS_DeadlineReachedUs(uint64_t deadlineUs);
+
+/*
+ * Returns whether millisecond time "a" is later than millisecond time "b"
+ *  - Correct across the wrap of SystemTime as long as the two are less than ~24 days apart
+ */
+static inline bool G8RTOS_TimeAfter(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) > 0);
+}
+
+/*
+ * Returns whether millisecond time "a" is later than or equal to millisecond time "b"
+ */
+static inline bool G8RTOS_TimeAfterEq(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) >= 0);
+}
+
+/*
+ * Returns whether a millisecond deadline (in SystemTime units) has been reached
+ * Param "deadlineMs": Absolute deadline in milliseconds
+ */
+bool G8RTOS_DeadlineReached(uint32_t deadlineMs);
+
+/*
+ * Returns the number of milliseconds elapsed since a SystemTime value
+ *  - Unsigned subtraction, correct across the wrap of SystemTime
+ * Param "startMs": Start of the measured interval
+ */
+uint32_t G8RTOS_ElapsedMs(uint32_t startMs);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_TIME_H_ */
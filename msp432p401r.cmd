@@ -94,6 +94,7 @@ SECTIONS
     /* BSL area for device bootstrap loader                                  */
     .bslArea      : > 0x00202000
 
+    /* SRAM copy of the vector table (G8RTOS_Dispatch.c) */
     .vtable :   > 0x20000000
     .data   :   > SRAM_DATA
     .bss    :   > SRAM_DATA
@@ -102,7 +103,8 @@ SECTIONS
 
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
-    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE, table(BINIT)
+    /* RAMFUNC code (USE_RAMFUNC), allocated from the top so it stays clear of the vector table copied to 0x20000000 */
+    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE(HIGH), table(BINIT)
 #endif
 #endif
 }
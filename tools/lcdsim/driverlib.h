@@ -0,0 +1,40 @@
+/*
+ * driverlib.h
+ *
+ * Host stand-in for the driverlib calls LCDLib makes, the uDMA and GPIO calls are implemented in sim.c
+ */
+
+#include "msp.h"
+typedef struct { uint32_t a, b, c, d, e, f, g; } eUSCI_SPI_MasterConfig;
+#define EUSCI_SPI_CLOCKSOURCE_SMCLK 0
+#define EUSCI_SPI_MSB_FIRST 0
+#define EUSCI_SPI_PHASE_DATA_CHANGED_ONFIRST_CAPTURED_ON_NEXT 0
+#define EUSCI_SPI_CLOCKPOLARITY_INACTIVITY_HIGH 0
+#define EUSCI_SPI_3PIN 0
+#define EUSCI_SPI_TRANSMIT_INTERRUPT 2
+#define EUSCI_B3_BASE 0x40002C00
+static inline bool SPI_initMaster(uint32_t a, const eUSCI_SPI_MasterConfig *c) { return true; }
+static inline void SPI_enableModule(uint32_t a) {}
+static inline void SPI_enableInterrupt(uint32_t a, uint32_t b) {}
+static inline void SPI_changeMasterClock(uint32_t a, uint32_t b, uint32_t c) {}
+static inline uint32_t SPI_getTransmitBufferAddressForDMA(uint32_t a) { return 0x1234; }
+typedef struct { volatile void *srcEndAddr; volatile void *dstEndAddr; volatile uint32_t control; volatile uint32_t spare; } DMA_ControlTable;
+#define UDMA_PRI_SELECT 0
+#define UDMA_SIZE_8 0
+#define UDMA_SRC_INC_NONE 0x0c000000
+#define UDMA_SRC_INC_8 0
+#define UDMA_DST_INC_NONE 0xc0000000
+#define UDMA_ARB_1 0
+#define UDMA_MODE_BASIC 1
+#define UDMA_ATTR_ALTSELECT 1
+#define UDMA_ATTR_USEBURST 2
+#define UDMA_ATTR_HIGH_PRIORITY 4
+#define UDMA_ATTR_REQMASK 8
+#define DMA_CH6_EUSCIB3TX0 0x02000006
+#define DMA_INT1 31
+void DMA_enableModule(void); void DMA_setControlBase(void *t); void DMA_assignChannel(uint32_t m);
+void DMA_disableChannelAttribute(uint32_t c, uint32_t a); void DMA_assignInterrupt(uint32_t i, uint32_t c);
+void DMA_clearInterruptFlag(uint32_t c); void DMA_enableInterrupt(uint32_t i);
+void DMA_setChannelControl(uint32_t i, uint32_t c); void DMA_setChannelTransfer(uint32_t i, uint32_t m, void *s, void *d, uint32_t n);
+void DMA_enableChannel(uint32_t c);
+void GPIO_interruptEdgeSelect(uint32_t, uint32_t, uint32_t);
@@ -0,0 +1,50 @@
+/*
+ * msp.h
+ *
+ * Host stand-in for the device header, only what LCDLib touches
+ */
+
+#ifndef STUB_MSP_H
+#define STUB_MSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#define BIT0 0x01
+#define BIT1 0x02
+#define BIT2 0x04
+#define BIT3 0x08
+#define BIT4 0x10
+#define BIT5 0x20
+#define BIT6 0x40
+#define BIT7 0x80
+typedef struct { volatile uint8_t OUT, DIR, SEL0, SEL1, IE, IES, IFG, REN, IN; } port_t;
+extern port_t stubP10, stubP4;
+#define P10 (&stubP10)
+#define P4 (&stubP4)
+#define P10OUT (stubP10.OUT)
+#define P10DIR (stubP10.DIR)
+extern volatile uint8_t stubTx, stubRx, stubIfg;
+uint16_t stub_statw(void);
+volatile uint8_t *stub_tx(void);
+#define UCB3TXBUF (*stub_tx())
+#define UCB3RXBUF stubRx
+#define UCB3STATW (stub_statw())
+#define UCBUSY 1
+#define UCB3IFG stubIfg
+#define UCTXIFG 2
+#define EUSCIB3_IRQn 21
+#define DMA_INT1_IRQn 31
+#define PORT4_IRQn 38
+static inline void NVIC_SetPriority(int a, int b) {}
+static inline void NVIC_EnableIRQ(int a) {}
+static inline void __delay_cycles(int a) {}
+
+#endif /* STUB_MSP_H */
+#ifdef SPI_CS_LOW
+#undef SPI_CS_LOW
+#undef SPI_CS_HIGH
+void sim_cs(int high);
+#define SPI_CS_LOW sim_cs(0)
+#define SPI_CS_HIGH sim_cs(1)
+
+#endif /* STUB_MSP_H */
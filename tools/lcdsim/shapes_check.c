@@ -0,0 +1,293 @@
+/*
+ * shapes_check.c
+ *
+ * Compares LCDShapes against per pixel reference rasterizers on the host
+ *  - LCDLib runs unchanged against the ILI9325 model in sim.c, the GRAM it leaves is compared with the reference
+ *  - Random lines, circles and rounded rectangles, many of them partly or completely off screen
+ *  - Prints the SPI bytes of a few shapes next to drawing them with LCD_SetPoint
+ *
+ * Build and run from the repository root:
+ *      gcc -std=gnu99 -fgnu89-inline -Wall -Wno-unknown-pragmas -Itools/lcdsim -IBoardSupportPackage/inc \
+ *          -o shapes_check tools/lcdsim/shapes_check.c tools/lcdsim/sim.c BoardSupportPackage/src/LCDLib.c \
+ *          BoardSupportPackage/src/AsciiLib.c BoardSupportPackage/src/LCDShapes.c && ./shapes_check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "LCDShapes.h"
+
+#define LINES       400
+#define SHAPES      300
+#define MAX_OUTLINE 2048
+
+extern uint16_t gram[240][320];
+extern unsigned long spiBytes;
+
+/* Expected screen */
+static uint16_t expected[MAX_SCREEN_Y][MAX_SCREEN_X];
+
+/* Outline points of the last reference shape */
+static int outlineX[MAX_OUTLINE];
+static int outlineY[MAX_OUTLINE];
+static int outlineLength;
+
+static void Plot(int x, int y, uint16_t color)
+{
+    if (x >= 0 && x < MAX_SCREEN_X && y >= 0 && y < MAX_SCREEN_Y)
+    {
+        expected[y][x] = color;
+    }
+}
+
+static void AddOutline(int x, int y)
+{
+    outlineX[outlineLength] = x;
+    outlineY[outlineLength] = y;
+    outlineLength++;
+}
+
+/*
+ * Textbook Bresenham, one point at a time
+ */
+static void ReferenceLine(int x0, int y0, int x1, int y1, uint16_t color)
+{
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int error = dx + dy;
+
+    while (1)
+    {
+        Plot(x0, y0, color);
+        if (x0 == x1 && y0 == y1)
+        {
+            break;
+        }
+
+        int e2 = 2 * error;
+        if (e2 >= dy) { error += dy; x0 += sx; }
+        if (e2 <= dx) { error += dx; y0 += sy; }
+    }
+}
+
+/*
+ * Textbook eight way midpoint circle with one center per quadrant, plus the straight edges between them.
+ * Filled shapes cover every row from its leftmost to its rightmost outline point
+ */
+static void ReferenceRound(int left, int right, int top, int bottom, int radius, uint16_t color, int fill)
+{
+    int x = 0;
+    int y = radius;
+    int decision = 1 - radius;
+    int i = 0;
+
+    outlineLength = 0;
+    while (x <= y)
+    {
+        AddOutline(right + x, bottom + y); AddOutline(left - x, bottom + y);
+        AddOutline(right + x, top - y);    AddOutline(left - x, top - y);
+        AddOutline(right + y, bottom + x); AddOutline(left - y, bottom + x);
+        AddOutline(right + y, top - x);    AddOutline(left - y, top - x);
+
+        if (decision < 0) { decision += 2 * x + 3; }
+        else { decision += 2 * (x - y) + 5; y--; }
+        x++;
+    }
+    for (i = left; i <= right; i++)
+    {
+        AddOutline(i, top - radius);
+        AddOutline(i, bottom + radius);
+    }
+    for (i = top; i <= bottom; i++)
+    {
+        AddOutline(left - radius, i);
+        AddOutline(right + radius, i);
+    }
+
+    if (!fill)
+    {
+        for (i = 0; i < outlineLength; i++)
+        {
+            Plot(outlineX[i], outlineY[i], color);
+        }
+        return;
+    }
+
+    for (y = top - radius; y <= bottom + radius; y++)
+    {
+        int first = 1 << 20;
+        int last = -(1 << 20);
+
+        for (i = 0; i < outlineLength; i++)
+        {
+            if (outlineY[i] == y)
+            {
+                first = (outlineX[i] < first) ? outlineX[i] : first;
+                last = (outlineX[i] > last) ? outlineX[i] : last;
+            }
+        }
+        for (x = first; x <= last; x++)
+        {
+            Plot(x, y, color);
+        }
+    }
+}
+
+static void ClearBoth()
+{
+    int x = 0;
+    int y = 0;
+
+    LCD_Clear(LCD_BLACK);
+    for (y = 0; y < MAX_SCREEN_Y; y++)
+    {
+        for (x = 0; x < MAX_SCREEN_X; x++)
+        {
+            expected[y][x] = LCD_BLACK;
+        }
+    }
+}
+
+static int Compare(const char *what)
+{
+    int x = 0;
+    int y = 0;
+    int bad = 0;
+
+    for (y = 0; y < MAX_SCREEN_Y; y++)
+    {
+        for (x = 0; x < MAX_SCREEN_X; x++)
+        {
+            bad += (gram[y][x] != expected[y][x]);
+        }
+    }
+
+    if (bad)
+    {
+        printf("%s: %d pixels differ\n", what, bad);
+    }
+    return bad;
+}
+
+int main()
+{
+    char what[64];
+    int bad = 0;
+    int i = 0;
+
+    LCD_Init(false);
+    srand(5);
+
+    for (i = 0; i < LINES; i++)
+    {
+        int x0 = rand() % 400 - 40, y0 = rand() % 320 - 40;
+        int x1 = rand() % 400 - 40, y1 = rand() % 320 - 40;
+
+        /* a few points, horizontal and vertical lines */
+        if (i < 8)
+        {
+            x1 = x0 + (i % 3) * 7;
+            y1 = y0 + (i % 2) * 9;
+        }
+
+        ClearBoth();
+        LCD_DrawLine(x0, y0, x1, y1, LCD_WHITE);
+        ReferenceLine(x0, y0, x1, y1, LCD_WHITE);
+        snprintf(what, sizeof(what), "line (%d,%d)-(%d,%d)", x0, y0, x1, y1);
+        bad += Compare(what);
+    }
+
+    for (i = 0; i < SHAPES; i++)
+    {
+        int x = rand() % 400 - 40, y = rand() % 320 - 40;
+        int r = rand() % ((i < 100) ? 8 : 90);
+
+        ClearBoth();
+        LCD_DrawCircle(x, y, r, LCD_RED);
+        ReferenceRound(x, x, y, y, r, LCD_RED, 0);
+        snprintf(what, sizeof(what), "circle (%d,%d) r %d", x, y, r);
+        bad += Compare(what);
+
+        ClearBoth();
+        LCD_FillCircle(x, y, r, LCD_RED);
+        ReferenceRound(x, x, y, y, r, LCD_RED, 1);
+        snprintf(what, sizeof(what), "filled circle (%d,%d) r %d", x, y, r);
+        bad += Compare(what);
+    }
+
+    for (i = 0; i < SHAPES; i++)
+    {
+        int x = rand() % 360 - 20, y = rand() % 280 - 20;
+        int w = 1 + rand() % 120, h = 1 + rand() % 100;
+        int r = rand() % 30;
+        int size = (w < h) ? w : h;
+        int fit = (r < (size - 1) / 2) ? r : (size - 1) / 2;
+
+        ClearBoth();
+        LCD_DrawRoundRect(x, x + w, y, y + h, r, LCD_GREEN);
+        ReferenceRound(x + fit, x + w - 1 - fit, y + fit, y + h - 1 - fit, fit, LCD_GREEN, 0);
+        snprintf(what, sizeof(what), "round rect (%d,%d) %dx%d r %d", x, y, w, h, r);
+        bad += Compare(what);
+
+        ClearBoth();
+        LCD_FillRoundRect(x, x + w, y, y + h, r, LCD_GREEN);
+        ReferenceRound(x + fit, x + w - 1 - fit, y + fit, y + h - 1 - fit, fit, LCD_GREEN, 1);
+        snprintf(what, sizeof(what), "filled round rect (%d,%d) %dx%d r %d", x, y, w, h, r);
+        bad += Compare(what);
+    }
+
+    /* SPI traffic against one LCD_SetPoint per pixel of the reference */
+    {
+        unsigned long spans = 0;
+        unsigned long points = 0;
+        int x = 0;
+        int y = 0;
+
+        ClearBoth();
+        spiBytes = 0;
+        LCD_FillCircle(160, 120, 20, LCD_BLUE);
+        spans = spiBytes;
+
+        ClearBoth();
+        ReferenceRound(160, 160, 120, 120, 20, LCD_BLUE, 1);
+        spiBytes = 0;
+        for (y = 0; y < MAX_SCREEN_Y; y++)
+        {
+            for (x = 0; x < MAX_SCREEN_X; x++)
+            {
+                if (expected[y][x] == LCD_BLUE)
+                {
+                    LCD_SetPoint(x, y, LCD_BLUE);
+                }
+            }
+        }
+        points = spiBytes;
+        printf("filled circle r 20: %lu SPI bytes, %lu with LCD_SetPoint\n", spans, points);
+
+        ClearBoth();
+        spiBytes = 0;
+        LCD_DrawLine(10, 10, 300, 60, LCD_BLUE);
+        spans = spiBytes;
+
+        ClearBoth();
+        ReferenceLine(10, 10, 300, 60, LCD_BLUE);
+        spiBytes = 0;
+        for (y = 0; y < MAX_SCREEN_Y; y++)
+        {
+            for (x = 0; x < MAX_SCREEN_X; x++)
+            {
+                if (expected[y][x] == LCD_BLUE)
+                {
+                    LCD_SetPoint(x, y, LCD_BLUE);
+                }
+            }
+        }
+        points = spiBytes;
+        printf("line 290x50: %lu SPI bytes, %lu with LCD_SetPoint\n", spans, points);
+    }
+
+    printf("%s, %d pixels differ\n", bad ? "FAILED" : "passed", bad);
+    return bad != 0;
+}
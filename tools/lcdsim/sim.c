@@ -0,0 +1,125 @@
+/*
+ * sim.c
+ *
+ * ILI9325 model behind the stubbed EUSCI_B3 and uDMA
+ *  - Every byte written to UCB3TXBUF is parsed as an index (0x70) or data (0x72) transfer while CS is low
+ *  - GRAM writes follow the window registers 0x50-0x53 and the cursor 0x20/0x21 like the panel does
+ *  - A uDMA transfer is sent at once and completed by calling DMA_INT1_IRQHandler
+ */
+
+#include <stdio.h>
+#include "msp.h"
+#include "driverlib.h"
+
+port_t stubP10, stubP4;
+volatile uint8_t stubTx, stubRx, stubIfg = UCTXIFG;
+
+uint16_t gram[240][320];
+uint16_t regs[256];
+unsigned long spiBytes;
+
+/* parser state of the current CS low period */
+static int pos, start;
+static uint16_t idx, word;
+static int hor, ver;
+static int txPending;
+
+static uint32_t ctl;
+static const uint8_t *src;
+static uint32_t n;
+
+extern void DMA_INT1_IRQHandler(void);
+
+static void byte(uint8_t b)
+{
+    spiBytes++;
+    if (stubP10.OUT & BIT4)
+    {
+        /* touch panel or CS high */
+        return;
+    }
+
+    if (pos == 0)
+    {
+        start = b;
+        pos = 1;
+        if (b == 0x70) idx = 0;
+        return;
+    }
+    if (start == 0x70)
+    {
+        idx = (idx << 8) | b;
+        pos++;
+        return;
+    }
+    if (start == 0x72)
+    {
+        word = (word << 8) | b;
+        pos++;
+        if ((pos & 1) == 1)
+        {
+            if (idx == 0x22)
+            {
+                if (hor < 240 && ver < 320) gram[hor][ver] = word;
+                ver++;
+                if (ver > regs[0x53]) { ver = regs[0x52]; hor++; if (hor > regs[0x51]) hor = regs[0x50]; }
+            }
+            else
+            {
+                regs[idx] = word;
+                if (idx == 0x20) hor = word;
+                if (idx == 0x21) ver = word;
+            }
+        }
+    }
+}
+
+void sim_cs(int high)
+{
+    if (high)
+    {
+        stubP10.OUT |= BIT4;
+    }
+    else
+    {
+        stubP10.OUT &= ~BIT4;
+        pos = 0;
+        word = 0;
+    }
+}
+
+/* a byte goes out when LCDLib writes TXBUF, it is clocked when the busy flag is polled */
+volatile uint8_t *stub_tx(void) { txPending = 1; return &stubTx; }
+uint16_t stub_statw(void) { if (txPending) { txPending = 0; byte(stubTx); } return 0; }
+
+void DMA_enableModule(void) {}
+void DMA_setControlBase(void *t) {}
+void DMA_assignChannel(uint32_t m) {}
+void DMA_disableChannelAttribute(uint32_t c, uint32_t a) {}
+void DMA_assignInterrupt(uint32_t i, uint32_t c) {}
+void DMA_clearInterruptFlag(uint32_t c) {}
+void DMA_enableInterrupt(uint32_t i) {}
+void DMA_setChannelControl(uint32_t i, uint32_t c) { ctl = c; }
+void GPIO_interruptEdgeSelect(uint32_t a, uint32_t b, uint32_t c) {}
+
+void DMA_setChannelTransfer(uint32_t i, uint32_t m, void *s, void *d, uint32_t count)
+{
+    src = s;
+    n = count;
+    if (count > 1024 || count == 0)
+    {
+        printf("bad dma size %u\n", (unsigned int)count);
+    }
+}
+
+void DMA_enableChannel(uint32_t c)
+{
+    uint32_t i = 0;
+
+    stubIfg |= UCTXIFG;
+    for (i = 0; i < n; i++)
+    {
+        byte(((ctl & UDMA_SRC_INC_NONE) == UDMA_SRC_INC_NONE) ? src[0] : src[i]);
+    }
+    DMA_INT1_IRQHandler();
+}
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+sprite2c.py
+
+Converts an image into an LCD_Sprite for LCDSprite.h
+
+    python3 sprite2c.py ball.png --name ball --format rle --key ff00ff > ball.c
+
+ - Formats: raw (RGB565 per pixel), pal8 (at most 256 colors, one byte per pixel), rle (runs of RGB565),
+   auto picks the smallest
+ - --key makes the given color transparent, it is compared after conversion to RGB565
+ - Reads binary PPM (P6) without extra packages, any other format needs Pillow
+"""
+
+import argparse
+import sys
+
+RLE_LITERAL = 0x8000
+RLE_MAX_RUN = 0x7FFF
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    pos += 1
+
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        sys.exit('%s: only 8 bit binary PPM (P6) is read without Pillow' % path)
+
+    width, height = int(fields[1]), int(fields[2])
+    rgb = data[pos:pos + 3 * width * height]
+    return width, height, [tuple(rgb[i:i + 3]) for i in range(0, len(rgb), 3)]
+
+
+def read_image(path):
+    if path.lower().endswith('.ppm'):
+        return read_ppm(path)
+
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('%s: install Pillow or convert the image to PPM first' % path)
+
+    image = Image.open(path).convert('RGB')
+    return image.width, image.height, list(image.getdata())
+
+
+def rgb565(r, g, b):
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def encode_rle(pixels):
+    """Runs of two or more equal pixels become repeat runs, everything else is gathered into literal runs"""
+    words = []
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:RLE_MAX_RUN]
+            del literal[:RLE_MAX_RUN]
+            words.append(RLE_LITERAL | len(chunk))
+            words.extend(chunk)
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == pixels[i] and run < RLE_MAX_RUN:
+            run += 1
+
+        if run >= 2:
+            flush()
+            words.extend([run, pixels[i]])
+        else:
+            literal.append(pixels[i])
+        i += run
+
+    flush()
+    return words
+
+
+def c_array(ctype, name, values, per_line, digits):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join('0x%0*X' % (digits, v) for v in values[i:i + per_line]) + ',')
+    return 'static const %s %s[%d] = {\n%s\n};\n' % (ctype, name, len(values), '\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an image into an LCD_Sprite')
+    parser.add_argument('image')
+    parser.add_argument('--name', required=True, help='C name of the sprite')
+    parser.add_argument('--format', choices=['raw', 'pal8', 'rle', 'auto'], default='auto')
+    parser.add_argument('--key', help='transparent color as RRGGBB')
+    args = parser.parse_args()
+
+    width, height, rgb = read_image(args.image)
+    if width > 320:
+        sys.exit('%s: %d pixels wide, LCD_SPRITE_MAX_WIDTH is 320' % (args.image, width))
+
+    pixels = [rgb565(*p) for p in rgb]
+    key = rgb565(*bytes.fromhex(args.key)) if args.key else None
+
+    palette = sorted(set(pixels))
+    rle = encode_rle(pixels)
+    sizes = {'raw': 2 * len(pixels), 'rle': 2 * len(rle)}
+    if len(palette) <= 256:
+        sizes['pal8'] = len(pixels) + 2 * len(palette)
+
+    fmt = args.format
+    if fmt == 'auto':
+        fmt = min(sizes, key=sizes.get)
+    if fmt not in sizes:
+        sys.exit('%s: %d colors, pal8 holds at most 256' % (args.image, len(palette)))
+
+    out = ['/* %s, %dx%d, %s, %d bytes (raw %d) */\n' % (args.image, width, height, fmt, sizes[fmt], sizes['raw']),
+           '#include "LCDSprite.h"\n\n']
+    palette_name = '0'
+    if fmt == 'raw':
+        out.append(c_array('uint16_t', args.name + '_data', pixels, 12, 4))
+    elif fmt == 'pal8':
+        index = {color: i for i, color in enumerate(palette)}
+        palette_name = args.name + '_palette'
+        out.append(c_array('uint16_t', palette_name, palette, 12, 4))
+        out.append('\n')
+        out.append(c_array('uint8_t', args.name + '_data', [index[p] for p in pixels], 16, 2))
+    else:
+        out.append(c_array('uint16_t', args.name + '_data', rle, 12, 4))
+
+    out.append('\nconst LCD_Sprite %s = { %d, %d, LCD_SPRITE_%s, %s, 0x%04X, %s, %s_data };\n' % (
+        args.name, width, height, fmt.upper(), 'true' if key is not None else 'false',
+        key if key is not None else 0, palette_name, args.name))
+
+    sys.stdout.write(''.join(out))
+
+
+if __name__ == '__main__':
+    main()